@@ -0,0 +1,36 @@
+#ifndef ATTRACTOR_HPP
+#define ATTRACTOR_HPP
+
+#include "GLM.hpp"
+
+// One row of InstanceBufferSSBO in Shaders/instances.glsl, std430 layout
+struct AttractorInstance
+{
+    glm::vec4 Parameters{0.0f};
+    glm::mat4 Transform{1.0f};
+    glm::vec4 Color{1.0f};
+    // x: first particle, y: particle count
+    glm::uvec4 Range{0u};
+};
+static_assert(sizeof(AttractorInstance) == 112);
+
+// Editable description of an instance. Fixed layout as it is also stored in checkpoints
+struct AttractorInstanceSettings
+{
+    glm::vec4 Parameters{-1.4f, 1.6f, 1.0f, 0.7f};
+    glm::vec3 Position{0.0f};
+    // Euler angles in degrees, applied as yaw (Y), pitch (X), roll (Z)
+    glm::vec3 Rotation{0.0f};
+    float Scale = 1.0f;
+    glm::vec3 Color{1.0f};
+    // Share of the particles given to this instance, relative to the other instances
+    float Weight = 1.0f;
+
+    [[nodiscard]] glm::mat4 GetTransform() const
+    {
+        const auto rotation = glm::eulerAngleYXZ(glm::radians(Rotation.y), glm::radians(Rotation.x), glm::radians(Rotation.z));
+        return glm::translate(glm::mat4{1.0f}, Position) * rotation * glm::scale(glm::mat4{1.0f}, glm::vec3(Scale));
+    }
+};
+
+#endif //ATTRACTOR_HPP
@@ -0,0 +1,282 @@
+#include "Checkpoint.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t alignCheckpointOffset(const uint64_t offset)
+{
+    return (offset + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+}
+
+static std::string writeCheckpointFile(const std::string &path, const CheckpointHeader &header, const char *staging, const std::vector<char> &instanceTable)
+{
+    std::ofstream file{path, std::ios::out | std::ios::trunc | std::ios::binary};
+    if (!file.is_open())
+    {
+        return "Failed to open checkpoint for write: " + path;
+    }
+
+    const auto writePadding = [&file](const uint64_t offset)
+    {
+        const std::vector<char> zeros(offset - static_cast<uint64_t>(file.tellp()), '\0');
+        file.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writePadding(header.ParticleBufferOffset);
+    file.write(staging, static_cast<std::streamsize>(header.ParticleBufferSize));
+    writePadding(header.PixelBufferOffset);
+    file.write(staging + header.ParticleBufferSize, static_cast<std::streamsize>(header.PixelBufferSize));
+    writePadding(header.InstanceTableOffset);
+    file.write(instanceTable.data(), static_cast<std::streamsize>(instanceTable.size()));
+    file.close();
+
+    if (file.fail())
+    {
+        return "Failed to write checkpoint: " + path;
+    }
+    return "Saved checkpoint: " + path;
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    if (writeResult.valid())
+    {
+        writeResult.wait();
+    }
+    if (fence != nullptr)
+    {
+        glDeleteSync(fence);
+    }
+    releaseStaging();
+}
+
+bool CheckpointWriter::Begin(const std::string &path, const CheckpointHeader &header, const SSBO &particles, const SSBO &pixels, const void *instanceTable, const uint64_t instanceTableSize)
+{
+    if (Busy())
+    {
+        return false;
+    }
+
+    this->path = path;
+    this->header = header;
+    this->header.ParticleBufferOffset = alignCheckpointOffset(sizeof(CheckpointHeader));
+    this->header.ParticleBufferSize = particles.Size;
+    this->header.PixelBufferOffset = alignCheckpointOffset(this->header.ParticleBufferOffset + particles.Size);
+    this->header.PixelBufferSize = pixels.Size;
+    this->header.InstanceTableOffset = alignCheckpointOffset(this->header.PixelBufferOffset + pixels.Size);
+    this->header.InstanceTableSize = instanceTableSize;
+
+    const auto instanceBytes = static_cast<const char *>(instanceTable);
+    this->instanceTable.assign(instanceBytes, instanceBytes + instanceTableSize);
+
+    const uint64_t totalSize = static_cast<uint64_t>(particles.Size) + pixels.Size;
+    if (stagingSize != totalSize)
+    {
+        releaseStaging();
+
+        constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &stagingBuffer);
+        glNamedBufferStorage(stagingBuffer, static_cast<GLsizeiptr>(totalSize), nullptr, flags | GL_CLIENT_STORAGE_BIT);
+        stagingPointer = static_cast<const char *>(glMapNamedBufferRange(stagingBuffer, 0, static_cast<GLsizeiptr>(totalSize), flags));
+        stagingSize = totalSize;
+    }
+
+    // Make the compute shader's writes visible to the copies
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glCopyNamedBufferSubData(particles.GLBuffer, stagingBuffer, 0, 0, particles.Size);
+    glCopyNamedBufferSubData(pixels.GLBuffer, stagingBuffer, 0, particles.Size, pixels.Size);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    Status = "Reading back checkpoint...";
+    return true;
+}
+
+void CheckpointWriter::Poll()
+{
+    if (fence != nullptr)
+    {
+        const auto waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            return;
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+
+        if (waitResult == GL_WAIT_FAILED || stagingPointer == nullptr)
+        {
+            Status = "Checkpoint readback failed";
+            return;
+        }
+
+        writeResult = std::async(std::launch::async, writeCheckpointFile, path, header, stagingPointer, std::cref(instanceTable));
+        Status = "Writing checkpoint: " + path;
+    }
+
+    if (writeResult.valid() && writeResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        Status = writeResult.get();
+    }
+}
+
+bool CheckpointWriter::Busy() const
+{
+    return fence != nullptr || writeResult.valid();
+}
+
+void CheckpointWriter::releaseStaging()
+{
+    if (stagingBuffer != 0)
+    {
+        glUnmapNamedBuffer(stagingBuffer);
+        glDeleteBuffers(1, &stagingBuffer);
+    }
+    stagingBuffer = 0;
+    stagingSize = 0;
+    stagingPointer = nullptr;
+}
+
+CheckpointFile::CheckpointFile(const std::string &path)
+{
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        fileHandle = nullptr;
+        throw std::runtime_error("Failed to open checkpoint: " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    size = static_cast<uint64_t>(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle != nullptr)
+    {
+        data = static_cast<const char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        throw std::runtime_error("Failed to open checkpoint: " + path);
+    }
+
+    struct stat fileStat{};
+    fstat(fileDescriptor, &fileStat);
+    size = static_cast<uint64_t>(fileStat.st_size);
+
+    void *mapping = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) : MAP_FAILED;
+    close(fileDescriptor);
+    if (mapping != MAP_FAILED)
+    {
+        data = static_cast<const char *>(mapping);
+    }
+#endif
+
+    if (data == nullptr)
+    {
+        unmap();
+        throw std::runtime_error("Failed to map checkpoint: " + path);
+    }
+
+    if (size >= offsetof(CheckpointHeader, HeaderSize) + sizeof(uint32_t))
+    {
+        // Older headers are shorter, leaving the appended fields zeroed
+        const auto headerSize = std::min<uint64_t>(reinterpret_cast<const CheckpointHeader *>(data)->HeaderSize, std::min<uint64_t>(size, sizeof(CheckpointHeader)));
+        std::memcpy(&header, data, headerSize);
+    }
+
+    try
+    {
+        validate(path);
+    }
+    catch (...)
+    {
+        unmap();
+        throw;
+    }
+}
+
+void CheckpointFile::validate(const std::string &path) const
+{
+    if (size < offsetof(CheckpointHeader, HeaderSize) + sizeof(uint32_t) || std::memcmp(header.Magic, CheckpointHeader{}.Magic, sizeof(header.Magic)) != 0)
+    {
+        throw std::runtime_error("Not a checkpoint file: " + path);
+    }
+    if (header.Version < 1 || header.Version > CHECKPOINT_VERSION || header.HeaderSize > sizeof(CheckpointHeader) || header.HeaderSize > size)
+    {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(header.Version) + ": " + path);
+    }
+    if (header.ParticleBufferOffset + header.ParticleBufferSize > size || header.PixelBufferOffset + header.PixelBufferSize > size || header.InstanceTableOffset + header.InstanceTableSize > size)
+    {
+        throw std::runtime_error("Truncated checkpoint: " + path);
+    }
+}
+
+CheckpointFile::~CheckpointFile()
+{
+    unmap();
+}
+
+void CheckpointFile::unmap()
+{
+#ifdef _WIN32
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+    }
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data != nullptr)
+    {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+    data = nullptr;
+}
+
+const CheckpointHeader &CheckpointFile::Header() const
+{
+    return header;
+}
+
+const void *CheckpointFile::ParticleData() const
+{
+    return data + Header().ParticleBufferOffset;
+}
+
+const void *CheckpointFile::PixelData() const
+{
+    return data + Header().PixelBufferOffset;
+}
+
+const void *CheckpointFile::InstanceTable() const
+{
+    return Header().InstanceTableSize > 0 ? data + Header().InstanceTableOffset : nullptr;
+}
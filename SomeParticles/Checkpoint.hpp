@@ -0,0 +1,115 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "SSBO.hpp"
+
+// Version 2 appended the attractor instance table; version 1 files hold a single attractor.
+// Version 3 appended the view layout, the pixel buffer holding one layer per view
+#define CHECKPOINT_VERSION 3
+// Buffer contents are aligned to this within the file so they can be mapped directly
+#define CHECKPOINT_ALIGNMENT 4096
+
+enum class PixelPackingFormat : uint32_t
+{
+    R21G22B21 = 0,
+    // Same packing, each layer stored in Morton ordered blocks, see PixelLayout.hpp
+    R21G22B21Morton = 1,
+};
+
+// Fixed layout, little-endian. The raw particle and pixel buffers and the instance table follow at their offsets.
+// New fields are only ever appended, so older headers are a prefix of newer ones
+struct CheckpointHeader
+{
+    char Magic[8] = {'S', 'P', 'C', 'K', 'P', 'T', '\0', '\0'};
+    uint32_t Version = CHECKPOINT_VERSION;
+    uint32_t HeaderSize = sizeof(CheckpointHeader);
+
+    float Attractors[4] = {};
+    float EyePos[3] = {};
+    float EMax = 0.0f;
+    int32_t Resolution[2] = {};
+    int32_t DispatchSize[3] = {};
+    PixelPackingFormat PackingFormat = PixelPackingFormat::R21G22B21;
+    uint64_t AccumulatedFrames = 0;
+
+    uint64_t ParticleBufferOffset = 0;
+    uint64_t ParticleBufferSize = 0;
+    uint64_t PixelBufferOffset = 0;
+    uint64_t PixelBufferSize = 0;
+
+    // Version 2: AttractorInstanceSettings records
+    uint32_t InstanceCount = 0;
+    uint32_t InstanceRecordSize = 0;
+    uint64_t InstanceTableOffset = 0;
+    uint64_t InstanceTableSize = 0;
+
+    // Version 3: ViewMode and the number of pixel buffer layers
+    uint32_t ViewMode = 0;
+    uint32_t ViewCount = 0;
+};
+
+// Reads the particle and pixel buffers back through a persistently mapped staging buffer and a fence,
+// then writes the file on a worker thread so neither the GPU nor the render loop stalls
+class CheckpointWriter
+{
+public:
+    CheckpointWriter() = default;
+    ~CheckpointWriter();
+
+    std::string Status;
+
+    // Queues the GPU copies; returns false if a previous checkpoint is still being written
+    bool Begin(const std::string &path, const CheckpointHeader &header, const SSBO &particles, const SSBO &pixels, const void *instanceTable, uint64_t instanceTableSize);
+    // Call once per frame to start and finish the write when the readback has completed
+    void Poll();
+    [[nodiscard]] bool Busy() const;
+
+private:
+    std::string path;
+    CheckpointHeader header;
+    std::vector<char> instanceTable;
+    unsigned int stagingBuffer = 0;
+    uint64_t stagingSize = 0;
+    const char *stagingPointer = nullptr;
+    GLsync fence = nullptr;
+    std::future<std::string> writeResult;
+
+    void releaseStaging();
+};
+
+// A checkpoint file mapped read-only into memory
+class CheckpointFile
+{
+public:
+    explicit CheckpointFile(const std::string &path);
+    ~CheckpointFile();
+
+    CheckpointFile(const CheckpointFile &) = delete;
+    CheckpointFile &operator=(const CheckpointFile &) = delete;
+
+    [[nodiscard]] const CheckpointHeader &Header() const;
+    [[nodiscard]] const void *ParticleData() const;
+    [[nodiscard]] const void *PixelData() const;
+    // Null for version 1 checkpoints
+    [[nodiscard]] const void *InstanceTable() const;
+
+private:
+    const char *data = nullptr;
+    uint64_t size = 0;
+    CheckpointHeader header;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+    void validate(const std::string &path) const;
+    void unmap();
+};
+
+#endif //CHECKPOINT_HPP
@@ -0,0 +1,303 @@
+#include "Distributed.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+using NativeSocket = SOCKET;
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using NativeSocket = int;
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define REDUCE_SSE2
+#endif
+
+static void initializeSockets()
+{
+#ifdef _WIN32
+    static const bool initialized = []
+    {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!initialized)
+    {
+        throw std::runtime_error("Failed to initialize Winsock");
+    }
+#endif
+}
+
+Socket::Socket(const intptr_t handle) : handle(handle)
+{
+}
+
+Socket::~Socket()
+{
+    close();
+}
+
+Socket::Socket(Socket &&other) noexcept : handle(other.handle), pending(std::move(other.pending))
+{
+    other.handle = -1;
+}
+
+Socket &Socket::operator=(Socket &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        handle = other.handle;
+        pending = std::move(other.pending);
+        other.handle = -1;
+    }
+    return *this;
+}
+
+void Socket::close()
+{
+    if (handle != -1)
+    {
+#ifdef _WIN32
+        closesocket(static_cast<SOCKET>(handle));
+#else
+        ::close(static_cast<int>(handle));
+#endif
+    }
+    handle = -1;
+}
+
+Socket Socket::Listen(const uint16_t port)
+{
+    initializeSockets();
+
+    const auto listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    Socket result{static_cast<intptr_t>(listener)};
+    if (result.handle == -1)
+    {
+        throw std::runtime_error("Failed to create socket");
+    }
+
+    constexpr int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+    {
+        throw std::runtime_error("Failed to listen on port " + std::to_string(port));
+    }
+    return result;
+}
+
+Socket Socket::Connect(const std::string &host, const uint16_t port)
+{
+    initializeSockets();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        throw std::runtime_error("Failed to resolve " + host);
+    }
+
+    Socket result;
+    for (auto address = addresses; address != nullptr && result.handle == -1; address = address->ai_next)
+    {
+        Socket candidate{static_cast<intptr_t>(socket(address->ai_family, address->ai_socktype, address->ai_protocol))};
+        if (candidate.handle != -1 && connect(static_cast<NativeSocket>(candidate.handle), address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0)
+        {
+            result = std::move(candidate);
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (result.handle == -1)
+    {
+        throw std::runtime_error("Failed to connect to " + host + ":" + std::to_string(port));
+    }
+    return result;
+}
+
+Socket Socket::ListenLocal(const std::string &path)
+{
+    initializeSockets();
+
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    const auto listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    Socket result{static_cast<intptr_t>(listener)};
+    if (result.handle == -1)
+    {
+        throw std::runtime_error("Failed to create socket");
+    }
+
+#ifdef _WIN32
+    DeleteFileA(path.c_str());
+#else
+    unlink(path.c_str());
+#endif
+    if (bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+    {
+        throw std::runtime_error("Failed to listen on " + path);
+    }
+    return result;
+}
+
+Socket Socket::Accept() const
+{
+    Socket result{static_cast<intptr_t>(accept(static_cast<NativeSocket>(handle), nullptr, nullptr))};
+    if (result.handle == -1)
+    {
+        throw std::runtime_error("Failed to accept connection");
+    }
+    return result;
+}
+
+void Socket::SendAll(const void *data, size_t size) const
+{
+    auto bytes = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        const auto chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+        const auto sent = send(static_cast<NativeSocket>(handle), bytes, chunk, 0);
+        if (sent <= 0)
+        {
+            throw std::runtime_error("Connection lost while sending");
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+}
+
+void Socket::ReceiveAll(void *data, size_t size) const
+{
+    auto bytes = static_cast<char *>(data);
+    while (size > 0)
+    {
+        const auto chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+        const auto received = recv(static_cast<NativeSocket>(handle), bytes, chunk, 0);
+        if (received <= 0)
+        {
+            throw std::runtime_error("Connection lost while receiving");
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+bool Socket::ReceiveLine(std::string &line)
+{
+    while (true)
+    {
+        const auto newline = pending.find('\n');
+        if (newline != std::string::npos)
+        {
+            line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            return true;
+        }
+
+        char buffer[4096];
+        const auto received = recv(static_cast<NativeSocket>(handle), buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+    }
+}
+
+// Channel masks of the R21G22B21 packing
+#define RED_BLUE_MASK 0x1FFFFFull
+#define GREEN_MASK 0x3FFFFFull
+
+static uint64_t packScaledSums(const uint64_t red, const uint64_t green, const uint64_t blue, const double scale)
+{
+    const auto channel = [scale](const uint64_t sum, const uint64_t mask)
+    {
+        return std::min(static_cast<uint64_t>(static_cast<double>(sum) * scale + 0.5), mask);
+    };
+    return (channel(red, RED_BLUE_MASK) << (21 + 22)) | (channel(green, GREEN_MASK) << 21) | channel(blue, RED_BLUE_MASK);
+}
+
+static void reduceRange(uint64_t *destination, const std::vector<const uint64_t *> &sources, const double scale, const size_t first, const size_t last)
+{
+    size_t i = first;
+#ifdef REDUCE_SSE2
+    // Two pixels per add; loads are unaligned as the buffers come straight from the network
+    const auto redBlueMask = _mm_set1_epi64x(RED_BLUE_MASK);
+    const auto greenMask = _mm_set1_epi64x(GREEN_MASK);
+    for (; i + 2 <= last; i += 2)
+    {
+        __m128i red = _mm_setzero_si128();
+        __m128i green = _mm_setzero_si128();
+        __m128i blue = _mm_setzero_si128();
+        for (const auto source : sources)
+        {
+            const auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            red = _mm_add_epi64(red, _mm_and_si128(_mm_srli_epi64(packed, 21 + 22), redBlueMask));
+            green = _mm_add_epi64(green, _mm_and_si128(_mm_srli_epi64(packed, 21), greenMask));
+            blue = _mm_add_epi64(blue, _mm_and_si128(packed, redBlueMask));
+        }
+
+        alignas(16) uint64_t sums[3][2];
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums[0]), red);
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums[1]), green);
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums[2]), blue);
+        destination[i] = packScaledSums(sums[0][0], sums[1][0], sums[2][0], scale);
+        destination[i + 1] = packScaledSums(sums[0][1], sums[1][1], sums[2][1], scale);
+    }
+#endif
+    for (; i < last; i++)
+    {
+        uint64_t red = 0;
+        uint64_t green = 0;
+        uint64_t blue = 0;
+        for (const auto source : sources)
+        {
+            red += (source[i] >> (21 + 22)) & RED_BLUE_MASK;
+            green += (source[i] >> 21) & GREEN_MASK;
+            blue += source[i] & RED_BLUE_MASK;
+        }
+        destination[i] = packScaledSums(red, green, blue, scale);
+    }
+}
+
+void ReducePixelBuffers(uint64_t *destination, const std::vector<const uint64_t *> &sources, const size_t count, const double scale, const unsigned int threadCount)
+{
+    // Even-sized ranges keep every thread's pairs of pixels together
+    const auto threads = std::max(threadCount, 1u);
+    const auto rangeSize = std::max<size_t>(((count + threads - 1) / threads + 1) & ~static_cast<size_t>(1), 2);
+
+    std::vector<std::thread> workers;
+    for (size_t first = 0; first < count; first += rangeSize)
+    {
+        workers.emplace_back(reduceRange, destination, std::cref(sources), scale, first, std::min(first + rangeSize, count));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
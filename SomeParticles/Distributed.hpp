@@ -0,0 +1,75 @@
+#ifndef DISTRIBUTED_HPP
+#define DISTRIBUTED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Identifies the messages exchanged between the coordinator and its workers
+#define RENDER_JOB_MAGIC 0x4A505053u
+#define RENDER_RESULT_MAGIC 0x52505053u
+
+// Sent by the coordinator to each worker, followed by InstanceCount AttractorInstanceSettings records.
+// Fixed layout, little-endian
+struct RenderJob
+{
+    uint32_t Magic = RENDER_JOB_MAGIC;
+    uint32_t WorkerIndex = 0;
+    uint32_t WorkerCount = 0;
+    // Deterministic frame indices, so workers render disjoint seed sequences
+    uint32_t FirstFrame = 0;
+    uint32_t FrameCount = 0;
+    int32_t Resolution[2] = {};
+    int32_t DispatchSize[3] = {};
+    float EMax = 0.0f;
+    float EyePos[3] = {};
+    uint32_t InstanceCount = 0;
+};
+
+// Sent back by a worker, followed by its raw R21G22B21 pixel buffer
+struct RenderResult
+{
+    uint32_t Magic = RENDER_RESULT_MAGIC;
+    uint32_t WorkerIndex = 0;
+    uint64_t PixelBufferSize = 0;
+};
+
+// Blocking TCP or Unix domain socket connection, closed on destruction. Errors throw std::runtime_error
+class Socket
+{
+public:
+    Socket() = default;
+    ~Socket();
+
+    Socket(Socket &&other) noexcept;
+    Socket &operator=(Socket &&other) noexcept;
+    Socket(const Socket &) = delete;
+    Socket &operator=(const Socket &) = delete;
+
+    static Socket Listen(uint16_t port);
+    static Socket Connect(const std::string &host, uint16_t port);
+    // Unix domain socket at path, replacing any stale socket file
+    static Socket ListenLocal(const std::string &path);
+    [[nodiscard]] Socket Accept() const;
+
+    void SendAll(const void *data, size_t size) const;
+    void ReceiveAll(void *data, size_t size) const;
+    // Reads up to the next newline, which is not included. Returns false once the peer has closed the connection
+    bool ReceiveLine(std::string &line);
+
+private:
+    intptr_t handle = -1;
+    // Bytes received past the last line
+    std::string pending;
+
+    explicit Socket(intptr_t handle);
+    void close();
+};
+
+// Sums the pixel buffers element-wise into destination. Each channel is unpacked and summed in 64 bits, so the sum
+// cannot carry from one channel into the next, then multiplied by scale and packed again, saturating each channel.
+// Splits the buffer across threadCount threads
+void ReducePixelBuffers(uint64_t *destination, const std::vector<const uint64_t *> &sources, size_t count, double scale, unsigned int threadCount);
+
+#endif //DISTRIBUTED_HPP
@@ -0,0 +1,104 @@
+#include "GLState.hpp"
+
+GLState::Counters GLState::CurrentFrame;
+GLState::Counters GLState::LastFrame;
+
+unsigned int GLState::program = unknown;
+unsigned int GLState::vertexArray = unknown;
+unsigned int GLState::storageBuffer = unknown;
+std::array<unsigned int, GLState::MaxTrackedBindings> GLState::storageBufferBindings = [] {
+    std::array<unsigned int, MaxTrackedBindings> bindings{};
+    bindings.fill(unknown);
+    return bindings;
+}();
+
+bool GLState::changeBinding(unsigned int &current, const unsigned int value)
+{
+    if (current == value)
+    {
+        CurrentFrame.Elided++;
+        return false;
+    }
+
+    current = value;
+    CurrentFrame.Issued++;
+    return true;
+}
+
+void GLState::UseProgram(const unsigned int program)
+{
+    if (changeBinding(GLState::program, program))
+    {
+        glUseProgram(program);
+    }
+}
+
+void GLState::BindVertexArray(const unsigned int vertexArray)
+{
+    if (changeBinding(GLState::vertexArray, vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+void GLState::BindStorageBuffer(const unsigned int buffer)
+{
+    if (changeBinding(storageBuffer, buffer))
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    }
+}
+
+void GLState::BindStorageBufferBase(const unsigned int index, const unsigned int buffer)
+{
+    if (index >= MaxTrackedBindings)
+    {
+        CurrentFrame.Issued++;
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+        storageBuffer = buffer;
+        return;
+    }
+
+    if (changeBinding(storageBufferBindings[index], buffer))
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+        storageBuffer = buffer;
+    }
+}
+
+void GLState::ForgetProgram(const unsigned int program)
+{
+    if (GLState::program == program)
+    {
+        GLState::program = unknown;
+    }
+}
+
+void GLState::ForgetBuffer(const unsigned int buffer)
+{
+    if (storageBuffer == buffer)
+    {
+        storageBuffer = unknown;
+    }
+    for (auto &binding : storageBufferBindings)
+    {
+        if (binding == buffer)
+        {
+            binding = unknown;
+        }
+    }
+}
+
+void GLState::Invalidate()
+{
+    program = unknown;
+    vertexArray = unknown;
+    storageBuffer = unknown;
+    storageBufferBindings.fill(unknown);
+}
+
+void GLState::BeginFrame()
+{
+    LastFrame = CurrentFrame;
+    CurrentFrame = {};
+}
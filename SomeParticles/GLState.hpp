@@ -0,0 +1,48 @@
+#ifndef GLSTATE_HPP
+#define GLSTATE_HPP
+
+#include <array>
+#include <glad/glad.h>
+
+// Shadows the bound program, VAO and shader storage bindings so redundant binds are skipped.
+// Anything that changes these bindings directly must go through here or call Invalidate
+class GLState
+{
+public:
+    static constexpr unsigned int MaxTrackedBindings = 16;
+
+    static void UseProgram(unsigned int program);
+    static void BindVertexArray(unsigned int vertexArray);
+    // Generic GL_SHADER_STORAGE_BUFFER binding
+    static void BindStorageBuffer(unsigned int buffer);
+    // Indexed GL_SHADER_STORAGE_BUFFER binding, which also sets the generic binding
+    static void BindStorageBufferBase(unsigned int index, unsigned int buffer);
+
+    // Must be called before the object is deleted, as GL may hand out its name again
+    static void ForgetProgram(unsigned int program);
+    static void ForgetBuffer(unsigned int buffer);
+    static void Invalidate();
+
+    struct Counters
+    {
+        unsigned int Issued = 0;
+        unsigned int Elided = 0;
+    };
+
+    // Starts counting a new frame, keeping the previous frame's totals in LastFrame
+    static void BeginFrame();
+    static Counters CurrentFrame;
+    static Counters LastFrame;
+
+private:
+    static constexpr unsigned int unknown = ~0u;
+
+    static unsigned int program;
+    static unsigned int vertexArray;
+    static unsigned int storageBuffer;
+    static std::array<unsigned int, MaxTrackedBindings> storageBufferBindings;
+
+    static bool changeBinding(unsigned int &current, unsigned int value);
+};
+
+#endif //GLSTATE_HPP
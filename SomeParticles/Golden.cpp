@@ -0,0 +1,280 @@
+#include "Golden.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Bumped when the golden file format changes
+#define GOLDEN_FILE_VERSION 1
+
+// Sum of the unpacked R21G22B21 channels
+static double unpackIntensity(const uint64_t packed)
+{
+    const auto r = static_cast<double>((packed >> (21 + 22)) & 0x1FFFFF);
+    const auto g = static_cast<double>((packed >> 21) & 0x3FFFFF);
+    const auto b = static_cast<double>(packed & 0x1FFFFF);
+    return r + g + b;
+}
+
+static double normalizedDistance(const std::vector<double> &a, const double totalA, const std::vector<double> &b, const double totalB)
+{
+    if (totalA <= 0.0 || totalB <= 0.0)
+    {
+        return totalA == totalB ? 0.0 : 2.0;
+    }
+
+    double distance = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        distance += std::abs(a[i] / totalA - b[i] / totalB);
+    }
+    return distance;
+}
+
+GoldenBlocks SumGoldenBlocks(const uint64_t *pixels, const int width, const int height)
+{
+    GoldenBlocks blocks;
+    blocks.Width = width;
+    blocks.Height = height;
+    const auto blocksX = (width + GOLDEN_BLOCK_SIZE - 1) / GOLDEN_BLOCK_SIZE;
+    const auto blocksY = (height + GOLDEN_BLOCK_SIZE - 1) / GOLDEN_BLOCK_SIZE;
+    blocks.Sums.assign(static_cast<size_t>(blocksX) * blocksY, 0);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const auto block = static_cast<size_t>(y / GOLDEN_BLOCK_SIZE) * blocksX + x / GOLDEN_BLOCK_SIZE;
+            blocks.Sums[block] += static_cast<uint64_t>(unpackIntensity(pixels[static_cast<size_t>(y) * width + x]));
+        }
+    }
+    return blocks;
+}
+
+GoldenComparison CompareGoldenBlocks(const GoldenBlocks &golden, const GoldenBlocks &candidate)
+{
+    if (golden.Width != candidate.Width || golden.Height != candidate.Height || golden.Sums.size() != candidate.Sums.size())
+    {
+        throw std::runtime_error("Golden resolution differs");
+    }
+
+    std::vector<double> goldenBlocks(golden.Sums.begin(), golden.Sums.end());
+    std::vector<double> candidateBlocks(candidate.Sums.begin(), candidate.Sums.end());
+    double goldenTotal = 0.0, candidateTotal = 0.0;
+    for (size_t i = 0; i < goldenBlocks.size(); i++)
+    {
+        goldenTotal += goldenBlocks[i];
+        candidateTotal += candidateBlocks[i];
+    }
+
+    GoldenComparison comparison;
+    comparison.FluxRatio = goldenTotal > 0.0 ? candidateTotal / goldenTotal : (candidateTotal > 0.0 ? INFINITY : 1.0);
+    comparison.BlockDistance = normalizedDistance(goldenBlocks, goldenTotal, candidateBlocks, candidateTotal);
+    comparison.Passed = std::abs(comparison.FluxRatio - 1.0) <= GOLDEN_FLUX_TOLERANCE && comparison.BlockDistance <= GOLDEN_DENSITY_TOLERANCE;
+    return comparison;
+}
+
+GoldenComparison CompareGoldenPixels(const uint64_t *golden, const uint64_t *candidate, const int width, const int height)
+{
+    const auto pixelCount = static_cast<size_t>(width) * height;
+    std::vector<double> goldenPixels(pixelCount), candidatePixels(pixelCount);
+    double goldenTotal = 0.0, candidateTotal = 0.0;
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        goldenPixels[i] = unpackIntensity(golden[i]);
+        candidatePixels[i] = unpackIntensity(candidate[i]);
+        goldenTotal += goldenPixels[i];
+        candidateTotal += candidatePixels[i];
+    }
+
+    auto comparison = CompareGoldenBlocks(SumGoldenBlocks(golden, width, height), SumGoldenBlocks(candidate, width, height));
+    comparison.PixelDistance = normalizedDistance(goldenPixels, goldenTotal, candidatePixels, candidateTotal);
+    return comparison;
+}
+
+void WriteGoldenBlocks(const std::string &path, const GoldenBlocks &blocks)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    const auto blocksX = (blocks.Width + GOLDEN_BLOCK_SIZE - 1) / GOLDEN_BLOCK_SIZE;
+    file << "SPGOLDEN " << GOLDEN_FILE_VERSION << ' ' << blocks.Width << ' ' << blocks.Height << '\n';
+    for (size_t i = 0; i < blocks.Sums.size(); i++)
+    {
+        file << blocks.Sums[i] << ((i + 1) % blocksX == 0 ? '\n' : ' ');
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+GoldenBlocks ReadGoldenBlocks(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    std::string magic;
+    int version = 0;
+    GoldenBlocks blocks;
+    file >> magic >> version >> blocks.Width >> blocks.Height;
+    if (!file || magic != "SPGOLDEN" || version != GOLDEN_FILE_VERSION || blocks.Width <= 0 || blocks.Height <= 0)
+    {
+        throw std::runtime_error("Not a golden file: " + path);
+    }
+
+    const auto blocksX = (blocks.Width + GOLDEN_BLOCK_SIZE - 1) / GOLDEN_BLOCK_SIZE;
+    const auto blocksY = (blocks.Height + GOLDEN_BLOCK_SIZE - 1) / GOLDEN_BLOCK_SIZE;
+    blocks.Sums.resize(static_cast<size_t>(blocksX) * blocksY);
+    for (auto &sum : blocks.Sums)
+    {
+        file >> sum;
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Truncated golden file: " + path);
+    }
+    return blocks;
+}
+
+// Mirrors findInstance in Shaders/instances.glsl
+static size_t findInstance(const std::vector<AttractorInstance> &instances, const uint32_t particleIndex)
+{
+    size_t low = 0;
+    size_t high = instances.size() - 1;
+    while (low < high)
+    {
+        const auto middle = (low + high + 1) / 2;
+        if (instances[middle].Range.x <= particleIndex)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+static glm::vec3 spawnPosition(const GoldenScene &scene, const uint32_t particleIndex, const uint32_t seed, const uint32_t counter)
+{
+    return (RandomUnitVec3(RandomWords(scene.Generator, scene.TeaRounds, particleIndex, seed, counter)) - 0.5f) * 2.0f;
+}
+
+// Mirrors storeColor in Shaders/particles.comp for a single view in row-major order
+static void storeColor(const GoldenScene &scene, std::vector<uint64_t> &pixels, const glm::vec3 &worldPosition, const glm::vec3 &color)
+{
+    const auto clipSpacePosition = scene.MVP * glm::vec4(worldPosition, 1.0f);
+    const auto w = std::abs(clipSpacePosition.w);
+    if (std::abs(clipSpacePosition.x) > w || std::abs(clipSpacePosition.y) > w || std::abs(clipSpacePosition.z) > w)
+    {
+        return;
+    }
+
+    int pixelCoord[2];
+    for (int axis = 0; axis < 2; axis++)
+    {
+        const auto windowCoord = static_cast<float>(scene.Resolution[axis]) * (0.5f * (clipSpacePosition[axis] / clipSpacePosition.w) + 0.5f);
+        pixelCoord[axis] = std::clamp(static_cast<int>(std::round(windowCoord - 0.5f)), 0, scene.Resolution[axis] - 1);
+    }
+
+    const glm::vec3 packedMax{(1 << 21) - 1, (1 << 22) - 1, (1 << 21) - 1};
+    const auto scale = packedMax / scene.EMax;
+    uint32_t uintRGB[3];
+    for (int channel = 0; channel < 3; channel++)
+    {
+        uintRGB[channel] = static_cast<uint32_t>(std::max(color[channel], 0.0f) * scale[channel]);
+    }
+    pixels[static_cast<size_t>(pixelCoord[1]) * scene.Resolution.x + pixelCoord[0]] += (static_cast<uint64_t>(uintRGB[0]) << (21 + 22)) | (static_cast<uint64_t>(uintRGB[1]) << 21) | uintRGB[2];
+}
+
+// Runs every frame for the particles in [first, last), as the burn-in and splat dispatches do
+static void renderParticles(const GoldenScene &scene, std::vector<uint64_t> &pixels, const uint32_t first, const uint32_t last)
+{
+    for (auto particleIndex = first; particleIndex < last; particleIndex++)
+    {
+        const auto &instance = scene.Instances[findInstance(scene.Instances, particleIndex)];
+        const glm::vec3 color{instance.Color};
+        // Cleared by updateAttractors
+        glm::vec3 pos{0.0f};
+
+        for (size_t frame = 0; frame < scene.FrameSeeds.size(); frame++)
+        {
+            const auto seed = scene.FrameSeeds[frame];
+            for (int step = 0; frame == 0 && step < scene.BurnInSteps; step++)
+            {
+                if (pos == glm::vec3(0.0f))
+                {
+                    pos = spawnPosition(scene, particleIndex, seed, static_cast<uint32_t>(step) + 1u);
+                    continue;
+                }
+
+                pos = AttractorStep(scene.Trig, pos, instance.Parameters);
+                if (glm::dot(pos, pos) > 10.0f)
+                {
+                    pos = glm::vec3(0.0f);
+                }
+            }
+
+            if (pos == glm::vec3(0.0f))
+            {
+                pos = spawnPosition(scene, particleIndex, seed, 0u);
+                continue;
+            }
+
+            pos = AttractorStep(scene.Trig, pos, instance.Parameters);
+            if (glm::dot(pos, pos) > 10.0f)
+            {
+                pos = glm::vec3(0.0f);
+                continue;
+            }
+
+            storeColor(scene, pixels, glm::vec3(instance.Transform * glm::vec4(pos, 1.0f)), color);
+        }
+    }
+}
+
+std::vector<uint64_t> RenderGoldenScene(const GoldenScene &scene, const unsigned int threadCount)
+{
+    const auto pixelCount = static_cast<size_t>(scene.Resolution.x) * scene.Resolution.y;
+    if (scene.Instances.empty() || scene.EMax <= 0.0f || pixelCount == 0)
+    {
+        throw std::runtime_error("Invalid golden scene");
+    }
+
+    // Each thread splats into its own buffer, summed afterwards as the atomics would have
+    const auto threads = std::max(threadCount, 1u);
+    const auto rangeSize = (scene.ParticleCount + threads - 1) / threads;
+    std::vector<std::vector<uint64_t>> threadPixels(threads, std::vector<uint64_t>(pixelCount, 0));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        const auto first = std::min(i * rangeSize, scene.ParticleCount);
+        const auto last = std::min(first + rangeSize, scene.ParticleCount);
+        workers.emplace_back(renderParticles, std::cref(scene), std::ref(threadPixels[i]), first, last);
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    auto pixels = std::move(threadPixels.front());
+    for (unsigned int i = 1; i < threads; i++)
+    {
+        for (size_t j = 0; j < pixelCount; j++)
+        {
+            pixels[j] += threadPixels[i][j];
+        }
+    }
+    return pixels;
+}
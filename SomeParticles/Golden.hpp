@@ -0,0 +1,70 @@
+#ifndef GOLDEN_HPP
+#define GOLDEN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Attractor.hpp"
+#include "Random.hpp"
+#include "Trig.hpp"
+
+// Pixels are summed over blocks of this size before comparing densities, averaging away per-pixel sampling noise
+#define GOLDEN_BLOCK_SIZE 8
+// Largest allowed relative difference in the total deposited color
+#define GOLDEN_FLUX_TOLERANCE 0.01
+// Largest allowed L1 distance between the normalized block densities, which ranges from 0 (identical) to 2 (disjoint)
+#define GOLDEN_DENSITY_TOLERANCE 0.02
+
+// Statistical comparison of two R21G22B21 pixel buffers of the same resolution
+struct GoldenComparison
+{
+    // Candidate total over golden total
+    double FluxRatio = 0.0;
+    // L1 distance of the normalized densities per pixel and per block. Block goldens have no per pixel distance
+    double PixelDistance = 0.0;
+    double BlockDistance = 0.0;
+    bool Passed = false;
+};
+
+// Summed intensity of every block of a row-major pixel buffer, row by row. All a golden needs to keep of a scene
+struct GoldenBlocks
+{
+    int Width = 0;
+    int Height = 0;
+    std::vector<uint64_t> Sums;
+};
+
+GoldenBlocks SumGoldenBlocks(const uint64_t *pixels, int width, int height);
+GoldenComparison CompareGoldenBlocks(const GoldenBlocks &golden, const GoldenBlocks &candidate);
+GoldenComparison CompareGoldenPixels(const uint64_t *golden, const uint64_t *candidate, int width, int height);
+
+// Text files of a "SPGOLDEN 1 <width> <height>" line, then one line of sums per row of blocks. Errors throw
+// std::runtime_error
+void WriteGoldenBlocks(const std::string &path, const GoldenBlocks &blocks);
+GoldenBlocks ReadGoldenBlocks(const std::string &path);
+
+// A deterministic single view render, as the regression sets it up
+struct GoldenScene
+{
+    // Rows of the instance table, ranges included
+    std::vector<AttractorInstance> Instances;
+    glm::mat4 MVP{1.0f};
+    glm::ivec2 Resolution{0};
+    float EMax = 0.0f;
+    RandomGenerator Generator = RandomGenerator::TEA;
+    int TeaRounds = 16;
+    TrigMode Trig = TrigMode::Native;
+    uint32_t ParticleCount = 0;
+    int BurnInSteps = 0;
+    // Seed of every frame, the first also seeding the burn-in
+    std::vector<uint32_t> FrameSeeds;
+};
+
+// CPU mirror of Shaders/particles.comp without the respawn queue, returning the row-major pixel buffer. Particles
+// starting from the same seeds soon part from the GPU's through rounding, so the result only matches statistically,
+// which is all the golden comparison asks. Splits the particles across threadCount threads
+std::vector<uint64_t> RenderGoldenScene(const GoldenScene &scene, unsigned int threadCount);
+
+#endif //GOLDEN_HPP
@@ -0,0 +1,282 @@
+#include "Json.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+// Recursive descent over the whole message
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string &text) : text(text)
+    {
+    }
+
+    JsonValue ParseDocument()
+    {
+        auto value = parseValue();
+        skipWhitespace();
+        if (position != text.size())
+        {
+            fail("Unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    const std::string &text;
+    size_t position = 0;
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::runtime_error("JSON: " + message + " at offset " + std::to_string(position));
+    }
+
+    void skipWhitespace()
+    {
+        while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r'))
+        {
+            position++;
+        }
+    }
+
+    bool consume(const char character)
+    {
+        skipWhitespace();
+        if (position < text.size() && text[position] == character)
+        {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char character)
+    {
+        if (!consume(character))
+        {
+            fail(std::string("Expected '") + character + "'");
+        }
+    }
+
+    bool consumeLiteral(const char *literal)
+    {
+        const std::string word{literal};
+        if (text.compare(position, word.size(), word) == 0)
+        {
+            position += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue()
+    {
+        skipWhitespace();
+        if (position >= text.size())
+        {
+            fail("Unexpected end of input");
+        }
+
+        JsonValue value;
+        const auto character = text[position];
+        if (character == '{')
+        {
+            position++;
+            value.Type = JsonType::Object;
+            if (!consume('}'))
+            {
+                do
+                {
+                    skipWhitespace();
+                    auto key = parseString();
+                    expect(':');
+                    value.Object.emplace_back(std::move(key), parseValue());
+                } while (consume(','));
+                expect('}');
+            }
+        }
+        else if (character == '[')
+        {
+            position++;
+            value.Type = JsonType::Array;
+            if (!consume(']'))
+            {
+                do
+                {
+                    value.Array.push_back(parseValue());
+                } while (consume(','));
+                expect(']');
+            }
+        }
+        else if (character == '"')
+        {
+            value.Type = JsonType::String;
+            value.String = parseString();
+        }
+        else if (consumeLiteral("true"))
+        {
+            value.Type = JsonType::Bool;
+            value.Bool = true;
+        }
+        else if (consumeLiteral("false"))
+        {
+            value.Type = JsonType::Bool;
+        }
+        else if (consumeLiteral("null"))
+        {
+            value.Type = JsonType::Null;
+        }
+        else
+        {
+            const auto start = text.c_str() + position;
+            char *end = nullptr;
+            value.Type = JsonType::Number;
+            value.Number = std::strtod(start, &end);
+            if (end == start)
+            {
+                fail("Unexpected character");
+            }
+            position += static_cast<size_t>(end - start);
+        }
+        return value;
+    }
+
+    std::string parseString()
+    {
+        if (position >= text.size() || text[position] != '"')
+        {
+            fail("Expected string");
+        }
+        position++;
+
+        std::string result;
+        while (position < text.size() && text[position] != '"')
+        {
+            auto character = text[position++];
+            if (character == '\\' && position < text.size())
+            {
+                character = text[position++];
+                switch (character)
+                {
+                    case 'n':
+                        character = '\n';
+                        break;
+                    case 't':
+                        character = '\t';
+                        break;
+                    case 'r':
+                        character = '\r';
+                        break;
+                    case 'b':
+                        character = '\b';
+                        break;
+                    case 'f':
+                        character = '\f';
+                        break;
+                    case 'u':
+                    {
+                        // Only code points below 0x80 are kept as-is, which covers paths and keys in practice
+                        if (position + 4 > text.size())
+                        {
+                            fail("Truncated escape");
+                        }
+                        const auto codePoint = std::strtoul(text.substr(position, 4).c_str(), nullptr, 16);
+                        position += 4;
+                        character = codePoint < 0x80 ? static_cast<char>(codePoint) : '?';
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+            result += character;
+        }
+
+        if (position >= text.size())
+        {
+            fail("Unterminated string");
+        }
+        position++;
+        return result;
+    }
+};
+
+JsonValue JsonValue::Parse(const std::string &text)
+{
+    return JsonParser{text}.ParseDocument();
+}
+
+const JsonValue *JsonValue::Find(const std::string &key) const
+{
+    for (const auto &[name, value] : Object)
+    {
+        if (name == key)
+        {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+double JsonValue::GetNumber(const std::string &key, const double fallback) const
+{
+    const auto value = Find(key);
+    return value != nullptr && value->Type == JsonType::Number ? value->Number : fallback;
+}
+
+std::string JsonValue::GetString(const std::string &key, const std::string &fallback) const
+{
+    const auto value = Find(key);
+    return value != nullptr && value->Type == JsonType::String ? value->String : fallback;
+}
+
+void JsonValue::GetNumbers(const std::string &key, float *values, const size_t count) const
+{
+    const auto value = Find(key);
+    if (value == nullptr)
+    {
+        return;
+    }
+    if (value->Type != JsonType::Array || value->Array.size() != count)
+    {
+        throw std::runtime_error("JSON: '" + key + "' must be an array of " + std::to_string(count) + " numbers");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = static_cast<float>(value->Array[i].Number);
+    }
+}
+
+std::string JsonQuote(const std::string &text)
+{
+    std::string result = "\"";
+    for (const auto character : text)
+    {
+        switch (character)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                    result += escaped;
+                }
+                else
+                {
+                    result += character;
+                }
+                break;
+        }
+    }
+    return result + "\"";
+}
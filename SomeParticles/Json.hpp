@@ -0,0 +1,42 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class JsonType
+{
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+};
+
+// Just enough JSON for the daemon's job messages. Parse errors throw std::runtime_error
+class JsonValue
+{
+public:
+    JsonType Type = JsonType::Null;
+    bool Bool = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<JsonValue> Array;
+    std::vector<std::pair<std::string, JsonValue>> Object;
+
+    static JsonValue Parse(const std::string &text);
+
+    // Null if this is not an object or has no such key
+    [[nodiscard]] const JsonValue *Find(const std::string &key) const;
+    [[nodiscard]] double GetNumber(const std::string &key, double fallback) const;
+    [[nodiscard]] std::string GetString(const std::string &key, const std::string &fallback) const;
+    // Reads an array of count numbers into values, leaving them unchanged if the key is missing
+    void GetNumbers(const std::string &key, float *values, size_t count) const;
+};
+
+// Quotes and escapes a string for embedding in JSON output
+std::string JsonQuote(const std::string &text);
+
+#endif //JSON_HPP
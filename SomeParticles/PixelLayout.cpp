@@ -0,0 +1,61 @@
+#include "PixelLayout.hpp"
+
+// Interleaves the low four bits of x and y, x in the even bits
+static uint32_t mortonCode(const uint32_t x, const uint32_t y)
+{
+    uint32_t code = 0;
+    for (uint32_t bit = 0; bit < 4; bit++)
+    {
+        code |= ((x >> bit) & 1u) << (2 * bit);
+        code |= ((y >> bit) & 1u) << (2 * bit + 1);
+    }
+    return code;
+}
+
+static size_t getBlockCount(const int size)
+{
+    return (static_cast<size_t>(size) + PIXEL_BLOCK_SIZE - 1) / PIXEL_BLOCK_SIZE;
+}
+
+size_t GetPixelBufferLength(const PixelLayout layout, const int width, const int height, const int layers)
+{
+    if (layout == PixelLayout::Morton)
+    {
+        return getBlockCount(width) * getBlockCount(height) * PIXEL_BLOCK_SIZE * PIXEL_BLOCK_SIZE * layers;
+    }
+    return static_cast<size_t>(width) * height * layers;
+}
+
+size_t GetPixelIndex(const PixelLayout layout, const int x, const int y, const int layer, const int width, const int height)
+{
+    if (layout == PixelLayout::Morton)
+    {
+        const auto blocksX = getBlockCount(width);
+        const auto blocksY = getBlockCount(height);
+        const auto block = (layer * blocksY + y / PIXEL_BLOCK_SIZE) * blocksX + x / PIXEL_BLOCK_SIZE;
+        return block * PIXEL_BLOCK_SIZE * PIXEL_BLOCK_SIZE + mortonCode(x, y);
+    }
+    return (static_cast<size_t>(layer) * height + y) * width + x;
+}
+
+std::vector<uint64_t> ToRowMajor(const PixelLayout layout, std::vector<uint64_t> pixels, const int width, const int height, const int layers)
+{
+    if (layout == PixelLayout::RowMajor)
+    {
+        return pixels;
+    }
+
+    std::vector<uint64_t> rowMajor(static_cast<size_t>(width) * height * layers);
+    size_t index = 0;
+    for (int layer = 0; layer < layers; layer++)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                rowMajor[index++] = pixels[GetPixelIndex(layout, x, y, layer, width, height)];
+            }
+        }
+    }
+    return rowMajor;
+}
@@ -0,0 +1,27 @@
+#ifndef PIXEL_LAYOUT_HPP
+#define PIXEL_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Matches PIXEL_BLOCK_SIZE in Shaders/pixel_index.glsl
+#define PIXEL_BLOCK_SIZE 16
+
+// Order of the pixels within each layer of the pixel buffer, see Shaders/pixel_index.glsl
+enum class PixelLayout : uint32_t
+{
+    RowMajor = 0,
+    // PIXEL_BLOCK_SIZE square blocks stored one after another, each in Morton order
+    Morton = 1,
+};
+
+// Number of pixels in a buffer of width x height layers, Morton layouts being padded to whole blocks
+size_t GetPixelBufferLength(PixelLayout layout, int width, int height, int layers);
+
+size_t GetPixelIndex(PixelLayout layout, int x, int y, int layer, int width, int height);
+
+// Reorders a buffer of width x height layers into row-major order, dropping any padding
+std::vector<uint64_t> ToRowMajor(PixelLayout layout, std::vector<uint64_t> pixels, int width, int height, int layers);
+
+#endif //PIXEL_LAYOUT_HPP
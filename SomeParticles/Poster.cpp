@@ -0,0 +1,315 @@
+#include "Poster.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// TIFF tags and field types used by the writer
+#define TIFF_IMAGE_WIDTH 256
+#define TIFF_IMAGE_LENGTH 257
+#define TIFF_BITS_PER_SAMPLE 258
+#define TIFF_COMPRESSION 259
+#define TIFF_PHOTOMETRIC 262
+#define TIFF_SAMPLES_PER_PIXEL 277
+#define TIFF_PLANAR_CONFIGURATION 284
+#define TIFF_TILE_WIDTH 322
+#define TIFF_TILE_LENGTH 323
+#define TIFF_TILE_OFFSETS 324
+#define TIFF_TILE_BYTE_COUNTS 325
+
+#define TIFF_SHORT 3
+#define TIFF_LONG 4
+#define TIFF_LONG8 16
+
+std::vector<uint8_t> ResolvePixels(const uint64_t *pixels, const int width, const int height, const glm::vec3 &coldColor, const glm::vec3 &hotColor, const float outputScalar)
+{
+    const glm::vec3 packedMax{(1 << 21) - 1, (1 << 22) - 1, (1 << 21) - 1};
+
+    std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; y++)
+    {
+        const auto source = pixels + static_cast<size_t>(height - 1 - y) * width;
+        const auto destination = rgb.data() + static_cast<size_t>(y) * width * 3;
+        for (int x = 0; x < width; x++)
+        {
+            const auto packed = source[x];
+            const glm::vec3 unpacked{static_cast<float>((packed >> (21 + 22)) & 0x1FFFFF), static_cast<float>((packed >> 21) & 0x3FFFFF), static_cast<float>(packed & 0x1FFFFF)};
+
+            auto color = unpacked / packedMax * outputScalar;
+            if (color.x > 0.0f && color.y > 0.0f && color.z > 0.0f)
+            {
+                color = glm::mix(coldColor, hotColor, color) * std::max(color.x, std::max(color.y, color.z));
+            }
+
+            for (int channel = 0; channel < 3; channel++)
+            {
+                destination[x * 3 + channel] = static_cast<uint8_t>(std::clamp(color[channel], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    }
+    return rgb;
+}
+
+glm::mat4 GetTileProjection(const int tileX, const int tileY, const int tileSize, const int width, const int height)
+{
+    // Tile bounds in NDC, which has y pointing up
+    const auto left = -1.0f + 2.0f * static_cast<float>(tileX * tileSize) / static_cast<float>(width);
+    const auto right = -1.0f + 2.0f * static_cast<float>((tileX + 1) * tileSize) / static_cast<float>(width);
+    const auto top = 1.0f - 2.0f * static_cast<float>(tileY * tileSize) / static_cast<float>(height);
+    const auto bottom = 1.0f - 2.0f * static_cast<float>((tileY + 1) * tileSize) / static_cast<float>(height);
+
+    const glm::vec3 scale{2.0f / (right - left), 2.0f / (top - bottom), 1.0f};
+    const glm::vec3 offset{-(right + left) / (right - left), -(top + bottom) / (top - bottom), 0.0f};
+    return glm::translate(glm::mat4{1.0f}, offset) * glm::scale(glm::mat4{1.0f}, scale);
+}
+
+TiledTiffWriter::TiledTiffWriter(const std::string &path, const int width, const int height, const int tileSize)
+    : Width(width), Height(height), TileSize(tileSize), TilesX((width + tileSize - 1) / tileSize), TilesY((height + tileSize - 1) / tileSize)
+{
+    if (width <= 0 || height <= 0 || tileSize <= 0 || tileSize % 16 != 0)
+    {
+        throw std::runtime_error("Poster size must be positive and the tile size a multiple of 16");
+    }
+
+    file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open poster for write: " + path);
+    }
+
+    const auto tileCount = static_cast<size_t>(TilesX) * TilesY;
+    const auto tileBytes = static_cast<uint64_t>(tileSize) * tileSize * 3;
+    bigTiff = tileCount * tileBytes + tileCount * 16 + 4096 > 0xFFFFFFFFull;
+    tileOffsets.resize(tileCount, 0);
+    tileByteCounts.resize(tileCount, 0);
+
+    // The directory offset is patched in by writeDirectory
+    if (bigTiff)
+    {
+        const uint16_t header[4] = {0x4949, 43, 8, 0};
+        const uint64_t directoryOffset = 0;
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(&directoryOffset), sizeof(directoryOffset));
+    }
+    else
+    {
+        const uint16_t header[2] = {0x4949, 42};
+        const uint32_t directoryOffset = 0;
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(&directoryOffset), sizeof(directoryOffset));
+    }
+
+    thread = std::thread(&TiledTiffWriter::writerLoop, this);
+}
+
+TiledTiffWriter::~TiledTiffWriter()
+{
+    {
+        std::lock_guard lock{mutex};
+        finishing = true;
+    }
+    condition.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+void TiledTiffWriter::WriteTile(const int tileX, const int tileY, std::vector<uint8_t> rgb)
+{
+    std::unique_lock lock{mutex};
+    condition.wait(lock, [this] { return queue.size() < POSTER_QUEUED_TILES; });
+    queue.push_back({static_cast<size_t>(tileY) * TilesX + tileX, std::move(rgb)});
+    condition.notify_all();
+}
+
+std::string TiledTiffWriter::Finish()
+{
+    {
+        std::lock_guard lock{mutex};
+        finishing = true;
+    }
+    condition.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+    if (error.empty() && std::find(tileByteCounts.begin(), tileByteCounts.end(), 0) != tileByteCounts.end())
+    {
+        error = "Poster is missing tiles";
+    }
+    if (error.empty())
+    {
+        writeDirectory();
+    }
+    file.close();
+    if (error.empty() && file.fail())
+    {
+        error = "Failed to write poster";
+    }
+    return error;
+}
+
+void TiledTiffWriter::writerLoop()
+{
+    while (true)
+    {
+        QueuedTile tile;
+        {
+            std::unique_lock lock{mutex};
+            condition.wait(lock, [this] { return !queue.empty() || finishing; });
+            if (queue.empty())
+            {
+                return;
+            }
+            tile = std::move(queue.front());
+            queue.pop_front();
+        }
+        condition.notify_all();
+
+        tileOffsets[tile.Index] = static_cast<uint64_t>(file.tellp());
+        tileByteCounts[tile.Index] = tile.RGB.size();
+        file.write(reinterpret_cast<const char *>(tile.RGB.data()), static_cast<std::streamsize>(tile.RGB.size()));
+        if (file.fail())
+        {
+            error = "Failed to write poster tile";
+        }
+    }
+}
+
+void TiledTiffWriter::writeDirectory()
+{
+    // Offsets must fall on a word boundary
+    if (file.tellp() % 2 != 0)
+    {
+        file.put('\0');
+    }
+
+    // Out-of-line arrays first, then the directory pointing at them
+    const auto writeArray = [this](const std::vector<uint64_t> &values) -> uint64_t
+    {
+        const auto offset = static_cast<uint64_t>(file.tellp());
+        for (const auto value : values)
+        {
+            if (bigTiff)
+            {
+                file.write(reinterpret_cast<const char *>(&value), sizeof(uint64_t));
+            }
+            else
+            {
+                const auto narrow = static_cast<uint32_t>(value);
+                file.write(reinterpret_cast<const char *>(&narrow), sizeof(uint32_t));
+            }
+        }
+        return offset;
+    };
+
+    const size_t inlineBytes = bigTiff ? 8 : 4;
+    const size_t offsetBytes = bigTiff ? 8 : 4;
+    const auto tileCount = tileOffsets.size();
+    const auto offsetsInline = tileCount * offsetBytes <= inlineBytes;
+    const auto tileOffsetsOffset = offsetsInline ? 0 : writeArray(tileOffsets);
+    const auto tileByteCountsOffset = offsetsInline ? 0 : writeArray(tileByteCounts);
+
+    const uint16_t bitsPerSample[4] = {8, 8, 8, 0};
+    const auto bitsPerSampleInline = sizeof(uint16_t) * 3 <= inlineBytes;
+    const auto bitsPerSampleOffset = static_cast<uint64_t>(file.tellp());
+    if (!bitsPerSampleInline)
+    {
+        file.write(reinterpret_cast<const char *>(bitsPerSample), sizeof(uint16_t) * 3);
+        file.put('\0');
+        file.put('\0');
+    }
+
+    struct Entry
+    {
+        uint16_t Tag;
+        uint16_t Type;
+        uint64_t Count;
+        uint64_t Value;
+    };
+
+    const uint16_t offsetType = bigTiff ? TIFF_LONG8 : TIFF_LONG;
+    uint64_t bitsPerSampleValue = bitsPerSampleOffset;
+    if (bitsPerSampleInline)
+    {
+        bitsPerSampleValue = 8ull | 8ull << 16 | 8ull << 32;
+    }
+
+    const std::vector<Entry> entries{
+        {TIFF_IMAGE_WIDTH, TIFF_LONG, 1, static_cast<uint64_t>(Width)},
+        {TIFF_IMAGE_LENGTH, TIFF_LONG, 1, static_cast<uint64_t>(Height)},
+        {TIFF_BITS_PER_SAMPLE, TIFF_SHORT, 3, bitsPerSampleValue},
+        {TIFF_COMPRESSION, TIFF_SHORT, 1, 1},
+        {TIFF_PHOTOMETRIC, TIFF_SHORT, 1, 2},
+        {TIFF_SAMPLES_PER_PIXEL, TIFF_SHORT, 1, 3},
+        {TIFF_PLANAR_CONFIGURATION, TIFF_SHORT, 1, 1},
+        {TIFF_TILE_WIDTH, TIFF_LONG, 1, static_cast<uint64_t>(TileSize)},
+        {TIFF_TILE_LENGTH, TIFF_LONG, 1, static_cast<uint64_t>(TileSize)},
+        {TIFF_TILE_OFFSETS, offsetType, tileCount, offsetsInline ? tileOffsets.front() : tileOffsetsOffset},
+        {TIFF_TILE_BYTE_COUNTS, offsetType, tileCount, offsetsInline ? tileByteCounts.front() : tileByteCountsOffset},
+    };
+
+    const auto directoryOffset = static_cast<uint64_t>(file.tellp());
+    if (bigTiff)
+    {
+        const uint64_t entryCount = entries.size();
+        file.write(reinterpret_cast<const char *>(&entryCount), sizeof(entryCount));
+        for (const auto &entry : entries)
+        {
+            file.write(reinterpret_cast<const char *>(&entry.Tag), sizeof(uint16_t));
+            file.write(reinterpret_cast<const char *>(&entry.Type), sizeof(uint16_t));
+            file.write(reinterpret_cast<const char *>(&entry.Count), sizeof(uint64_t));
+            file.write(reinterpret_cast<const char *>(&entry.Value), sizeof(uint64_t));
+        }
+        const uint64_t nextDirectory = 0;
+        file.write(reinterpret_cast<const char *>(&nextDirectory), sizeof(nextDirectory));
+
+        file.seekp(8);
+        file.write(reinterpret_cast<const char *>(&directoryOffset), sizeof(directoryOffset));
+    }
+    else
+    {
+        const auto entryCount = static_cast<uint16_t>(entries.size());
+        file.write(reinterpret_cast<const char *>(&entryCount), sizeof(entryCount));
+        for (const auto &entry : entries)
+        {
+            // SHORT values are left-justified in the 4-byte value field, which on little-endian is the low bytes
+            const auto count = static_cast<uint32_t>(entry.Count);
+            const auto value = static_cast<uint32_t>(entry.Value);
+            file.write(reinterpret_cast<const char *>(&entry.Tag), sizeof(uint16_t));
+            file.write(reinterpret_cast<const char *>(&entry.Type), sizeof(uint16_t));
+            file.write(reinterpret_cast<const char *>(&count), sizeof(uint32_t));
+            file.write(reinterpret_cast<const char *>(&value), sizeof(uint32_t));
+        }
+        const uint32_t nextDirectory = 0;
+        file.write(reinterpret_cast<const char *>(&nextDirectory), sizeof(nextDirectory));
+
+        const auto narrowOffset = static_cast<uint32_t>(directoryOffset);
+        file.seekp(4);
+        file.write(reinterpret_cast<const char *>(&narrowOffset), sizeof(narrowOffset));
+    }
+}
+
+std::string WriteTiff(const std::string &path, const int width, const int height, const std::vector<uint8_t> &rgb)
+{
+    constexpr int tileSize = 256;
+    TiledTiffWriter writer{path, width, height, tileSize};
+    for (int tileY = 0; tileY < writer.TilesY; tileY++)
+    {
+        for (int tileX = 0; tileX < writer.TilesX; tileX++)
+        {
+            // Edge tiles are padded with black
+            std::vector<uint8_t> tile(static_cast<size_t>(tileSize) * tileSize * 3, 0);
+            const auto columns = std::min(tileSize, width - tileX * tileSize);
+            const auto rows = std::min(tileSize, height - tileY * tileSize);
+            for (int y = 0; y < rows; y++)
+            {
+                const auto source = rgb.begin() + (static_cast<size_t>(tileY * tileSize + y) * width + tileX * tileSize) * 3;
+                std::copy_n(source, columns * 3, tile.begin() + static_cast<size_t>(y) * tileSize * 3);
+            }
+            writer.WriteTile(tileX, tileY, std::move(tile));
+        }
+    }
+    return writer.Finish();
+}
@@ -0,0 +1,72 @@
+#ifndef POSTER_HPP
+#define POSTER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GLM.hpp"
+
+// Tiles waiting to be written before WriteTile blocks, bounding memory to a few tiles
+#define POSTER_QUEUED_TILES 2
+
+// Resolves an R21G22B21 pixel buffer to 8-bit RGB the same way output.frag does, flipping it so the first row is the top
+std::vector<uint8_t> ResolvePixels(const uint64_t *pixels, int width, int height, const glm::vec3 &coldColor, const glm::vec3 &hotColor, float outputScalar);
+
+// Offset and scale applied after the projection so that one tile of a width x height image fills clip space.
+// tileX and tileY count from the top left
+glm::mat4 GetTileProjection(int tileX, int tileY, int tileSize, int width, int height);
+
+// Uncompressed RGB TIFF made of square tiles, which are written on a background thread in any order as they are finished.
+// Switches to BigTIFF when the image cannot be addressed with 32-bit offsets
+class TiledTiffWriter
+{
+public:
+    TiledTiffWriter(const std::string &path, int width, int height, int tileSize);
+    ~TiledTiffWriter();
+
+    TiledTiffWriter(const TiledTiffWriter &) = delete;
+    TiledTiffWriter &operator=(const TiledTiffWriter &) = delete;
+
+    const int Width;
+    const int Height;
+    const int TileSize;
+    const int TilesX;
+    const int TilesY;
+
+    // rgb holds TileSize x TileSize pixels, top row first
+    void WriteTile(int tileX, int tileY, std::vector<uint8_t> rgb);
+    // Waits for the queued tiles and writes the directory. Returns the error, or an empty string on success
+    std::string Finish();
+
+private:
+    struct QueuedTile
+    {
+        size_t Index;
+        std::vector<uint8_t> RGB;
+    };
+
+    std::ofstream file;
+    bool bigTiff = false;
+    std::vector<uint64_t> tileOffsets;
+    std::vector<uint64_t> tileByteCounts;
+    std::string error;
+
+    std::deque<QueuedTile> queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool finishing = false;
+    std::thread thread;
+
+    void writerLoop();
+    void writeDirectory();
+};
+
+// Writes a whole RGB image, top row first, as a tiled TIFF. Returns the error, or an empty string on success
+std::string WriteTiff(const std::string &path, int width, int height, const std::vector<uint8_t> &rgb);
+
+#endif //POSTER_HPP
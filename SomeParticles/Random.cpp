@@ -0,0 +1,154 @@
+#include "Random.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include "Trig.hpp"
+
+// Density image of the seeding benchmark, covering [-SEEDING_EXTENT, SEEDING_EXTENT] in x and y
+#define SEEDING_RESOLUTION 64
+#define SEEDING_EXTENT 2.5f
+// Attractor steps splatted after spawning, the frames a restarted image is still converging over
+#define SEEDING_STEPS 4
+#define SEEDING_REFERENCE_PARTICLES (1u << 20)
+
+std::vector<std::string> GetRandomShaderDefines(const RandomGenerator generator, const int teaRounds)
+{
+    switch (generator)
+    {
+        case RandomGenerator::PCG:
+            return {"RNG_PCG"};
+        case RandomGenerator::Philox:
+            return {"RNG_PHILOX"};
+        case RandomGenerator::R3:
+            return {"RNG_R3"};
+        case RandomGenerator::TEA:
+        default:
+            return {"TEA_ROUNDS " + std::to_string(teaRounds)};
+    }
+}
+
+static double correlation(const std::vector<float> &a, const std::vector<float> &b)
+{
+    double sumA = 0.0, sumB = 0.0, sumAB = 0.0, sumAA = 0.0, sumBB = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        sumA += a[i];
+        sumB += b[i];
+        sumAB += static_cast<double>(a[i]) * b[i];
+        sumAA += static_cast<double>(a[i]) * a[i];
+        sumBB += static_cast<double>(b[i]) * b[i];
+    }
+
+    const auto n = static_cast<double>(a.size());
+    const auto covariance = sumAB / n - (sumA / n) * (sumB / n);
+    const auto varianceA = sumAA / n - (sumA / n) * (sumA / n);
+    const auto varianceB = sumBB / n - (sumB / n) * (sumB / n);
+    return covariance / std::sqrt(varianceA * varianceB);
+}
+
+RandomQualityReport EvaluateRandomQuality(const RandomGenerator generator, const int teaRounds, const uint32_t seed, const uint32_t sampleCount)
+{
+    RandomQualityReport report;
+    if (sampleCount < 2)
+    {
+        return report;
+    }
+
+    std::vector<glm::uvec4> words(sampleCount);
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < sampleCount; i++)
+    {
+        words[i] = RandomWords(generator, teaRounds, i, seed, 0);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+    report.NanosecondsPerSample = elapsed / sampleCount;
+
+    std::array<uint32_t, 256> buckets{};
+    std::array<uint32_t, 32> ones{};
+    std::vector<float> x(sampleCount), y(sampleCount);
+    double sum = 0.0;
+    for (uint32_t i = 0; i < sampleCount; i++)
+    {
+        const auto word = words[i].x;
+        buckets[word >> 24]++;
+        for (int bit = 0; bit < 32; bit++)
+        {
+            ones[bit] += (word >> bit) & 1u;
+        }
+
+        const auto unit = RandomUnitVec3(words[i]);
+        x[i] = unit.x;
+        y[i] = unit.y;
+        sum += unit.x;
+    }
+
+    const double expected = static_cast<double>(sampleCount) / buckets.size();
+    for (const auto count : buckets)
+    {
+        report.ChiSquare += (count - expected) * (count - expected) / expected;
+    }
+
+    for (const auto count : ones)
+    {
+        report.MaxBitBias = std::max(report.MaxBitBias, std::abs(static_cast<double>(count) / sampleCount - 0.5));
+    }
+
+    report.Mean = sum / sampleCount;
+    report.ComponentCorrelation = correlation(x, y);
+
+    const std::vector<float> current(x.begin(), x.end() - 1);
+    const std::vector<float> next(x.begin() + 1, x.end());
+    report.SerialCorrelation = correlation(current, next);
+
+    return report;
+}
+
+static std::vector<double> seedingImage(const RandomGenerator generator, const int teaRounds, const glm::vec4 &attractors, const uint32_t particleCount)
+{
+    std::vector<double> image(SEEDING_RESOLUTION * SEEDING_RESOLUTION, 0.0);
+    for (uint32_t i = 0; i < particleCount; i++)
+    {
+        // Spawned as in particles.comp
+        auto pos = (RandomUnitVec3(RandomWords(generator, teaRounds, i, 1u, 0u)) - 0.5f) * 2.0f;
+        for (int step = 0; step < SEEDING_STEPS; step++)
+        {
+            pos = AttractorStep(TrigMode::Native, pos, attractors);
+            const auto cell = glm::ivec2(glm::floor((glm::vec2(pos.x, pos.y) / SEEDING_EXTENT * 0.5f + 0.5f) * static_cast<float>(SEEDING_RESOLUTION)));
+            if (cell.x >= 0 && cell.y >= 0 && cell.x < SEEDING_RESOLUTION && cell.y < SEEDING_RESOLUTION)
+            {
+                image[cell.y * SEEDING_RESOLUTION + cell.x] += 1.0;
+            }
+        }
+    }
+
+    double total = 0.0;
+    for (const auto value : image)
+    {
+        total += value;
+    }
+    for (auto &value : image)
+    {
+        value = total > 0.0 ? value / total : 0.0;
+    }
+    return image;
+}
+
+std::vector<double> EvaluateSeedingConvergence(const RandomGenerator generator, const int teaRounds, const glm::vec4 &attractors, const std::vector<uint32_t> &particleCounts)
+{
+    // Random reference, so the quasi-random generators are not measured against their own structure
+    const auto reference = seedingImage(RandomGenerator::PCG, teaRounds, attractors, SEEDING_REFERENCE_PARTICLES);
+
+    std::vector<double> errors;
+    for (const auto particleCount : particleCounts)
+    {
+        const auto image = seedingImage(generator, teaRounds, attractors, particleCount);
+        double error = 0.0;
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            error += std::abs(image[i] - reference[i]);
+        }
+        errors.push_back(error);
+    }
+    return errors;
+}
@@ -0,0 +1,132 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GLM.hpp"
+
+// CPU mirror of Shaders/random.glsl, producing bit-identical results
+
+enum class RandomGenerator
+{
+    TEA,
+    PCG,
+    Philox,
+    // Low-discrepancy sequence over the particles rather than random numbers
+    R3,
+};
+
+// Shader defines selecting the generator in random.glsl
+std::vector<std::string> GetRandomShaderDefines(RandomGenerator generator, int teaRounds);
+
+inline uint32_t RandomTEA(const uint32_t val0, const uint32_t val1, const int rounds)
+{
+    uint32_t v0 = val0;
+    uint32_t v1 = val1;
+    uint32_t s0 = 0;
+
+    for (int n = 0; n < rounds; n++)
+    {
+        s0 += 0x9e3779b9;
+        v0 += ((v1 << 4) + 0xa341316c) ^ (v1 + s0) ^ ((v1 >> 5) + 0xc8013ea4);
+        v1 += ((v0 << 4) + 0xad90777d) ^ (v0 + s0) ^ ((v0 >> 5) + 0x7e95761e);
+    }
+
+    return v0;
+}
+
+inline uint32_t RandomLCG(uint32_t &prev)
+{
+    prev = 1664525u * prev + 1013904223u;
+    return prev;
+}
+
+inline glm::uvec4 RandomPCG4D(glm::uvec4 v)
+{
+    v = v * 1664525u + 1013904223u;
+    v.x += v.y * v.w;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    v.w += v.y * v.z;
+    v = glm::uvec4(v.x ^ (v.x >> 16u), v.y ^ (v.y >> 16u), v.z ^ (v.z >> 16u), v.w ^ (v.w >> 16u));
+    v.x += v.y * v.w;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    v.w += v.y * v.z;
+    return v;
+}
+
+inline glm::uvec4 RandomPhilox4x32(glm::uvec4 counter, glm::uvec2 key, const int rounds = 10)
+{
+    for (int i = 0; i < rounds; i++)
+    {
+        const uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * counter.x;
+        const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter.z;
+        const auto hi0 = static_cast<uint32_t>(product0 >> 32);
+        const auto lo0 = static_cast<uint32_t>(product0);
+        const auto hi1 = static_cast<uint32_t>(product1 >> 32);
+        const auto lo1 = static_cast<uint32_t>(product1);
+        counter = glm::uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key += glm::uvec2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return counter;
+}
+
+inline glm::uvec4 RandomR3(const uint32_t particleIndex, const uint32_t seed, const uint32_t counter)
+{
+    const glm::uvec3 alpha{0xD1B54A33u, 0xABC98389u, 0x8CB92BA7u};
+    const auto offset = RandomPCG4D(glm::uvec4(seed, counter, 0x6A09E667u, 0u));
+    return {alpha * particleIndex + glm::uvec3(offset), offset.w};
+}
+
+inline glm::uvec4 RandomWords(const RandomGenerator generator, const int teaRounds, const uint32_t particleIndex, const uint32_t seed, const uint32_t counter)
+{
+    switch (generator)
+    {
+        case RandomGenerator::PCG:
+            return RandomPCG4D(glm::uvec4(particleIndex, seed, counter, 0x2545F491u));
+        case RandomGenerator::Philox:
+            return RandomPhilox4x32(glm::uvec4(particleIndex, counter, 0u, 0u), glm::uvec2(seed, 0x5851F42Du));
+        case RandomGenerator::R3:
+            return RandomR3(particleIndex, seed, counter);
+        case RandomGenerator::TEA:
+        default:
+        {
+            uint32_t state = RandomTEA(particleIndex, seed ^ (counter * 0x9E3779B9u), teaRounds);
+            const auto x = RandomLCG(state);
+            const auto y = RandomLCG(state);
+            const auto z = RandomLCG(state);
+            const auto w = RandomLCG(state);
+            return {x, y, z, w};
+        }
+    }
+}
+
+inline glm::vec3 RandomUnitVec3(const glm::uvec4 &words)
+{
+    return glm::vec3(static_cast<float>(words.x >> 8u), static_cast<float>(words.y >> 8u), static_cast<float>(words.z >> 8u)) / static_cast<float>(0x01000000);
+}
+
+// Statistics over sampleCount consecutive particle indices with a fixed seed
+struct RandomQualityReport
+{
+    // 256 buckets of the top byte; expect about 255 +- 23
+    double ChiSquare = 0.0;
+    // Expect 0.5
+    double Mean = 0.0;
+    // Correlation between neighbouring particle indices and between components; expect about 0
+    double SerialCorrelation = 0.0;
+    double ComponentCorrelation = 0.0;
+    // Largest deviation of any bit's frequency of ones from 0.5
+    double MaxBitBias = 0.0;
+    double NanosecondsPerSample = 0.0;
+};
+
+RandomQualityReport EvaluateRandomQuality(RandomGenerator generator, int teaRounds, uint32_t seed, uint32_t sampleCount);
+
+// Relative L1 error against a reference of many more particles of the density image of each count of particles,
+// spawned by generator and iterated for a few steps. Measures how quickly a freshly seeded image settles
+std::vector<double> EvaluateSeedingConvergence(RandomGenerator generator, int teaRounds, const glm::vec4 &attractors, const std::vector<uint32_t> &particleCounts);
+
+#endif //RANDOM_HPP
@@ -1,5 +1,7 @@
 #include "SSBO.hpp"
 
+#include "GLState.hpp"
+
 SSBO::SSBO(const GLenum bufferUsageHint) : BufferUsageHint(bufferUsageHint)
 {
     glGenBuffers(1, &GLBuffer);
@@ -7,21 +9,46 @@ SSBO::SSBO(const GLenum bufferUsageHint) : BufferUsageHint(bufferUsageHint)
 
 SSBO::~SSBO()
 {
+    if (MappedPointer != nullptr)
+    {
+        glUnmapNamedBuffer(GLBuffer);
+    }
+    GLState::ForgetBuffer(GLBuffer);
     glDeleteBuffers(1, &GLBuffer);
 }
 
+// Immutable storage cannot be reallocated, so a new buffer object is needed
+static void recreateBufferObject(unsigned int &buffer, void *&mappedPointer)
+{
+    if (mappedPointer != nullptr)
+    {
+        glUnmapNamedBuffer(buffer);
+        mappedPointer = nullptr;
+    }
+    GLState::ForgetBuffer(buffer);
+    glDeleteBuffers(1, &buffer);
+    glGenBuffers(1, &buffer);
+}
+
 void SSBO::Bind() const
 {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, GLBuffer);
+    GLState::BindStorageBuffer(GLBuffer);
 }
 
 void SSBO::Unbind()
 {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    GLState::BindStorageBuffer(0);
 }
 
 void SSBO::Update(const void *data, const unsigned int size)
 {
+    if (Immutable)
+    {
+        recreateBufferObject(GLBuffer, MappedPointer);
+        Immutable = false;
+        Size = 0;
+    }
+
     Bind();
 
     if (Size != size)
@@ -37,6 +64,34 @@ void SSBO::Update(const void *data, const unsigned int size)
     Unbind();
 }
 
+void SSBO::UpdateRange(const unsigned int offset, const void *data, const unsigned int size)
+{
+    Bind();
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+    Unbind();
+}
+
+void SSBO::Storage(const void *data, const unsigned int size, const GLbitfield storageFlags)
+{
+    if (Immutable || Size != 0)
+    {
+        recreateBufferObject(GLBuffer, MappedPointer);
+    }
+
+    Bind();
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, data, storageFlags);
+    Unbind();
+
+    Size = size;
+    Immutable = true;
+
+    if (storageFlags & GL_MAP_PERSISTENT_BIT)
+    {
+        const GLbitfield mapFlags = storageFlags & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        MappedPointer = glMapNamedBufferRange(GLBuffer, 0, size, mapFlags);
+    }
+}
+
 SSBO::operator unsigned int() const
 {
     return GLBuffer;
@@ -10,6 +10,10 @@ public:
     unsigned int GLBuffer = 0;
     unsigned int Size = 0;
     const GLenum BufferUsageHint;
+    // Set when the buffer was allocated with immutable storage via Storage
+    bool Immutable = false;
+    // Non-null while the buffer is persistently mapped
+    void *MappedPointer = nullptr;
 
     explicit SSBO(GLenum bufferUsageHint = GL_DYNAMIC_DRAW);
     ~SSBO();
@@ -18,6 +22,10 @@ public:
     static void Unbind();
 
     void Update(const void *data, unsigned int size);
+    // Overwrites part of the existing allocation
+    void UpdateRange(unsigned int offset, const void *data, unsigned int size);
+    // Replaces the buffer with immutable storage, mapping it persistently when storageFlags contains GL_MAP_PERSISTENT_BIT
+    void Storage(const void *data, unsigned int size, GLbitfield storageFlags);
 
     template<typename T>
     void Update(const std::vector<T> &data)
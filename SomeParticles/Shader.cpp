@@ -2,9 +2,14 @@
 
 #include <fstream>
 #include <filesystem>
+#include <set>
+#include <sstream>
+#include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
 
+#include "GLState.hpp"
+
 unsigned int GetGLShaderType(const ShaderType type)
 {
     switch (type)
@@ -51,7 +56,14 @@ std::optional<std::string> GetPathFromShaderName(const std::string &shaderName)
     return {};
 }
 
-Shader::Shader(const std::string &shaderName, const ::ShaderType shaderType) : Type(shaderType)
+static std::unordered_map<std::string, std::string> registeredShaderSources;
+
+void RegisterShaderSource(const std::string &shaderName, const std::string &shaderSource)
+{
+    registeredShaderSources[shaderName] = shaderSource;
+}
+
+static std::string readShaderFile(const std::string &shaderName)
 {
     auto shaderPath = GetPathFromShaderName(shaderName);
     if (!shaderPath.has_value())
@@ -65,16 +77,95 @@ Shader::Shader(const std::string &shaderName, const ::ShaderType shaderType) : T
         throw std::runtime_error("Failed to open shader file " + shaderName);;
     }
     auto fileSize = shaderFile.tellg();
-    std::vector<char> shaderSource;
-    shaderSource.resize(static_cast<size_t>(fileSize) + 1);
+    std::string shaderSource;
+    shaderSource.resize(static_cast<size_t>(fileSize));
     shaderFile.seekg(0);
     shaderFile.read(shaderSource.data(), fileSize);
     shaderFile.close();
-    shaderSource.push_back('\0');
+    shaderSource.resize(static_cast<size_t>(shaderFile.gcount()));
+    return shaderSource;
+}
+
+static std::string resolveShaderIncludes(const std::string &shaderSource, std::set<std::string> &includedNames)
+{
+    std::istringstream input{shaderSource};
+    std::string result;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        const auto directive = line.find_first_not_of(" \t");
+        if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0)
+        {
+            result += line + '\n';
+            continue;
+        }
+
+        const auto nameStart = line.find('"', directive);
+        const auto nameEnd = nameStart == std::string::npos ? std::string::npos : line.find('"', nameStart + 1);
+        if (nameEnd == std::string::npos)
+        {
+            throw std::runtime_error("Malformed shader include: " + line);
+        }
+
+        // Every file is only included once
+        const auto includeName = line.substr(nameStart + 1, nameEnd - nameStart - 1);
+        if (!includedNames.insert(includeName).second)
+        {
+            continue;
+        }
+
+        const auto registered = registeredShaderSources.find(includeName);
+        const auto includeSource = registered != registeredShaderSources.end() ? registered->second : readShaderFile(includeName);
+        result += resolveShaderIncludes(includeSource, includedNames);
+    }
+    return result;
+}
+
+std::string PreprocessShaderSource(const std::string &shaderSource, const std::vector<std::string> &defines)
+{
+    std::set<std::string> includedNames;
+    return InsertShaderDefines(resolveShaderIncludes(shaderSource, includedNames), defines);
+}
+
+std::string InsertShaderDefines(const std::string &shaderSource, const std::vector<std::string> &defines)
+{
+    if (defines.empty())
+    {
+        return shaderSource;
+    }
+
+    std::string defineLines;
+    for (const auto &define : defines)
+    {
+        defineLines += "#define " + define + "\n";
+    }
+
+    // #version must remain the first directive, so the defines go on the line after it
+    size_t insertPosition = 0;
+    const auto versionPosition = shaderSource.find("#version");
+    if (versionPosition != std::string::npos)
+    {
+        const auto lineEnd = shaderSource.find('\n', versionPosition);
+        insertPosition = lineEnd == std::string::npos ? shaderSource.size() : lineEnd + 1;
+    }
+
+    std::string result = shaderSource;
+    if (insertPosition == result.size() && !result.empty() && result.back() != '\n')
+    {
+        result += '\n';
+        insertPosition++;
+    }
+    result.insert(insertPosition, defineLines);
+    return result;
+}
+
+Shader::Shader(const std::string &shaderName, const ::ShaderType shaderType, const std::vector<std::string> &defines) : Type(shaderType)
+{
+    const auto shaderSource = PreprocessShaderSource(readShaderFile(shaderName), defines);
 
     GLShader = glCreateShader(GetGLShaderType(shaderType));
 
-    const char *shaderSourcePointer = shaderSource.data();
+    const char *shaderSourcePointer = shaderSource.c_str();
     glShaderSource(GLShader, 1, &shaderSourcePointer, nullptr);
     glCompileShader(GLShader);
 
@@ -88,11 +179,12 @@ Shader::Shader(const std::string &shaderName, const ::ShaderType shaderType) : T
     }
 }
 
-Shader::Shader(const ::ShaderType shaderType, const std::string &shaderString) : Type(shaderType)
+Shader::Shader(const ::ShaderType shaderType, const std::string &shaderString, const std::vector<std::string> &defines) : Type(shaderType)
 {
     GLShader = glCreateShader(GetGLShaderType(shaderType));
 
-    const char *shaderSourcePointer = shaderString.c_str();
+    const auto shaderSource = PreprocessShaderSource(shaderString, defines);
+    const char *shaderSourcePointer = shaderSource.c_str();
     glShaderSource(GLShader, 1, &shaderSourcePointer, nullptr);
     glCompileShader(GLShader);
 
@@ -150,7 +242,7 @@ ShaderProgram::ShaderProgram(const std::shared_ptr<Shader> &vertexShader, const
 
     // VAO
     glGenVertexArrays(1, &GLVAO);
-    glBindVertexArray(GLVAO);
+    GLState::BindVertexArray(GLVAO);
     glEnableVertexAttribArray(0);
 }
 
@@ -178,32 +270,28 @@ ShaderProgram::~ShaderProgram()
 {
     if (GLProgram != 0)
     {
+        GLState::ForgetProgram(GLProgram);
         glDeleteProgram(GLProgram);
     }
 }
 
 void ShaderProgram::Use() const
 {
-    glUseProgram(GLProgram);
+    GLState::UseProgram(GLProgram);
     if (GLVAO != 0)
     {
-        glBindVertexArray(GLVAO);
+        GLState::BindVertexArray(GLVAO);
     }
 
+    // Bindings that are already current are skipped by GLState
     for (int i = 0; i < SSBOs.size(); i++)
     {
         const auto &ssbo = SSBOs[i];
-        if (ssbo == nullptr)
+        if (ssbo != nullptr)
         {
-            SSBO::Unbind();
-            continue;
+            GLState::BindStorageBufferBase(i, ssbo->GLBuffer);
         }
-
-        ssbo->Bind();
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, ssbo->GLBuffer);
     }
-
-    SSBO::Unbind();
 }
 
 ShaderProgram::operator unsigned int() const
@@ -213,7 +301,7 @@ ShaderProgram::operator unsigned int() const
 
 void ShaderProgram::Unbind()
 {
-    glUseProgram(0);
+    GLState::UseProgram(0);
 }
 
 int ShaderProgram::GetUniformLocation(const std::string &uniformName) const
@@ -341,11 +429,16 @@ void ShaderProgram::SetSSBO(const int index, const std::shared_ptr<SSBO> &ssbo)
 
 void ShaderProgram::SetSSBO(const std::string &bufferName, const std::shared_ptr<SSBO> &ssbo)
 {
+    // Blocks the compiler removed, or that this variant does not declare, have no binding
     auto index = GetProgramSSBOBinding(bufferName);
-    if (index < 0 || index >= SSBOs.size())
+    if (index < 0)
     {
         return;
     }
+    if (index >= static_cast<int>(SSBOs.size()))
+    {
+        throw std::runtime_error("Storage block " + bufferName + " uses binding " + std::to_string(index) + ", past the " + std::to_string(SSBOs.size()) + " tracked by ShaderProgram");
+    }
 
     SSBOs.at(index) = ssbo;
 }
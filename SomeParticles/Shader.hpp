@@ -3,7 +3,9 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 #include "GLM.hpp"
+#include "GLState.hpp"
 #include "SSBO.hpp"
 
 enum class ShaderType
@@ -16,13 +18,19 @@ enum class ShaderType
 
 unsigned int GetGLShaderType(ShaderType type);
 std::optional<std::string> GetPathFromShaderName(const std::string &shaderName);
+// Inserts a #define for each entry (e.g. "NAME" or "NAME VALUE") after the #version directive
+std::string InsertShaderDefines(const std::string &shaderSource, const std::vector<std::string> &defines);
+// Makes a source available to #include "shaderName" without reading it from disk (e.g. embedded shaders)
+void RegisterShaderSource(const std::string &shaderName, const std::string &shaderSource);
+// Expands #include "name" directives, then inserts the defines
+std::string PreprocessShaderSource(const std::string &shaderSource, const std::vector<std::string> &defines);
 
 
 class Shader
 {
 public:
-    explicit Shader(const std::string &shaderName, ShaderType shaderType);
-    explicit Shader(ShaderType shaderType, const std::string &shaderString);
+    explicit Shader(const std::string &shaderName, ShaderType shaderType, const std::vector<std::string> &defines = {});
+    explicit Shader(ShaderType shaderType, const std::string &shaderString, const std::vector<std::string> &defines = {});
     ~Shader();
     
     unsigned int GLShader = 0;
@@ -40,7 +48,8 @@ public:
 
     unsigned int GLProgram = 0;
     unsigned int GLVAO = 0;
-    std::array<std::shared_ptr<SSBO>, 8> SSBOs;
+    // Indexed by storage block binding. Every binding used by the shaders must fit
+    std::array<std::shared_ptr<SSBO>, GLState::MaxTrackedBindings> SSBOs;
 
     void Use() const;
     explicit operator unsigned int() const;
@@ -0,0 +1,36 @@
+// Attractor instance table, matching AttractorInstance in Attractor.hpp. Needs uniforms.glsl for InstanceCount
+
+struct AttractorInstance
+{
+    vec4 Parameters;
+    mat4 Transform;
+    vec4 Color;
+    // x: first particle, y: particle count
+    uvec4 Range;
+};
+
+// Sorted by Range.x, with the ranges covering every particle
+layout(std430, binding = 2) restrict readonly buffer InstanceBufferSSBO
+{
+    AttractorInstance Instances[];
+};
+
+// Binary search for the last instance whose range starts at or before the particle
+int findInstance(uint particleIndex)
+{
+    int low = 0;
+    int high = InstanceCount - 1;
+    while (low < high)
+    {
+        int middle = (low + high + 1) / 2;
+        if (Instances[middle].Range.x <= particleIndex)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
@@ -7,13 +7,9 @@ const vec3 packedMax = vec3((1 << 21) - 1, (1 << 22) - 1, (1 << 21) - 1);
 const uvec3 packingOffsets = uvec3(21 + 22, 21, 0);
 const uvec3 packingMasks = uvec3(0x1FFFFF, 0x3FFFFF, 0x1FFFFF);
 
-// Scales the particle color output by this value
-uniform float outputScalar;
-
-uniform vec3 ColdColor;
-uniform vec3 HotColor;
-
-uniform ivec2 RenderTextureDimensions;
+#include "uniforms.glsl"
+#include "tiles.glsl"
+#include "pixel_index.glsl"
 
 layout(std430, binding = 0) restrict readonly buffer PixelBufferSSBO
 {
@@ -23,14 +19,22 @@ layout(std430, binding = 0) restrict readonly buffer PixelBufferSSBO
 layout (location = 0) in vec2 uv;
 out vec4 outFragColor;
 
-vec3 unpack(ivec2 coord)
+vec3 unpack(ivec2 coord, int layer)
 {
-    if (coord.x < 0 || coord.x >= RenderTextureDimensions.x || coord.y < 0 || coord.y >= RenderTextureDimensions.y)
+    if (coord.x < 0 || coord.x >= RenderTextureDimensions.x || coord.y < 0 || coord.y >= RenderTextureDimensions.y || layer < 0 || layer >= ViewCount)
     {
         return vec3(0.0);
     }
 
-    int index = (coord.y * RenderTextureDimensions.x) + coord.x;
+#ifdef DIRTY_TILES
+    // Skip the pixel load for tiles nothing was splatted into
+    if (!isTileMarked(tileIndex(coord, layer, RenderTextureDimensions)))
+    {
+        return vec3(0.0);
+    }
+#endif
+
+    int index = pixelBufferIndex(coord, layer, RenderTextureDimensions);
     uint64_t packedRGB = uint64_t(PixelBuffer[index]);
 
     uvec3 uintRGB = uvec3(uint(packedRGB >> packingOffsets.r) & packingMasks.r, uint(packedRGB >> packingOffsets.g) & packingMasks.g, uint(packedRGB >> packingOffsets.b) & packingMasks.b);
@@ -40,12 +44,25 @@ vec3 unpack(ivec2 coord)
 
 void main()
 {
-    ivec2 pixelCoord = ivec2(uv * vec2(RenderTextureDimensions));
+    vec2 layerUV = uv;
+    int layer = OutputLayer;
+    if (OutputLayer < 0)
+    {
+        // Grid of every layer, first layer at the top left
+        const int columns = int(ceil(sqrt(float(ViewCount))));
+        const int rows = (ViewCount + columns - 1) / columns;
+        const vec2 grid = vec2(columns, rows);
+        const ivec2 cell = ivec2(floor(uv * grid));
+        layer = (rows - 1 - cell.y) * columns + cell.x;
+        layerUV = fract(uv * grid);
+    }
+
+    ivec2 pixelCoord = ivec2(layerUV * vec2(RenderTextureDimensions));
 
-    vec3 col = unpack(pixelCoord) * outputScalar;
+    vec3 col = unpack(pixelCoord, layer) * outputScalar;
     if (col.x > 0.0 && col.y > 0.0 && col.z > 0.0)
     {
-        col = mix(ColdColor, HotColor, col) * max(col.x, max(col.y, col.z));
+        col = mix(ColdColor.rgb, HotColor.rgb, col) * max(col.x, max(col.y, col.z));
     }
 
     outFragColor = vec4(col, 1.0);
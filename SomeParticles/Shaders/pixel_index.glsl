@@ -0,0 +1,28 @@
+// Position of a pixel within PixelBuffer, mirrored on the CPU by GetPixelIndex in PixelLayout.cpp.
+// Row-major unless PIXEL_LAYOUT_MORTON, which stores each PIXEL_BLOCK_SIZE x PIXEL_BLOCK_SIZE block of a layer
+// contiguously in Morton order, so splats close together on screen land in the same cache lines
+
+#define PIXEL_BLOCK_SIZE 16
+
+#ifdef PIXEL_LAYOUT_MORTON
+// Interleaves the low four bits of x and y, x in the even bits
+uint mortonCode(uvec2 coord)
+{
+    uvec2 spread = coord & uvec2(0xFu);
+    spread = (spread | (spread << 2u)) & uvec2(0x33u);
+    spread = (spread | (spread << 1u)) & uvec2(0x55u);
+    return spread.x | (spread.y << 1u);
+}
+#endif
+
+int pixelBufferIndex(ivec2 pixelCoord, int layer, ivec2 dimensions)
+{
+#ifdef PIXEL_LAYOUT_MORTON
+    const ivec2 blockCounts = (dimensions + ivec2(PIXEL_BLOCK_SIZE - 1)) / PIXEL_BLOCK_SIZE;
+    const ivec2 block = pixelCoord / PIXEL_BLOCK_SIZE;
+    const int blockStart = ((layer * blockCounts.y + block.y) * blockCounts.x + block.x) * PIXEL_BLOCK_SIZE * PIXEL_BLOCK_SIZE;
+    return blockStart + int(mortonCode(uvec2(pixelCoord)));
+#else
+    return (layer * dimensions.y + pixelCoord.y) * dimensions.x + pixelCoord.x;
+#endif
+}
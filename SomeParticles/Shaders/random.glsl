@@ -0,0 +1,99 @@
+// Counter-based random number generators, selected with RNG_PCG, RNG_PHILOX or RNG_R3 (TEA otherwise).
+// Random.hpp holds the matching CPU implementation
+
+#ifndef TEA_ROUNDS
+#define TEA_ROUNDS 16
+#endif
+
+#ifndef PHILOX_ROUNDS
+#define PHILOX_ROUNDS 10
+#endif
+
+// Generate a random unsigned int from two unsigned int values, using TEA_ROUNDS pairs
+// of rounds of the Tiny Encryption Algorithm. See Zafar, Olano, and Curtis,
+// "GPU Random Numbers via the Tiny Encryption Algorithm"
+uint tea(uint val0, uint val1)
+{
+    uint v0 = val0;
+    uint v1 = val1;
+    uint s0 = 0;
+
+    for (uint n = 0; n < TEA_ROUNDS; n++)
+    {
+        s0 += 0x9e3779b9;
+        v0 += ((v1 << 4) + 0xa341316c) ^ (v1 + s0) ^ ((v1 >> 5) + 0xc8013ea4);
+        v1 += ((v0 << 4) + 0xad90777d) ^ (v0 + s0) ^ ((v0 >> 5) + 0x7e95761e);
+    }
+
+    return v0;
+}
+
+// Advance the Numerical Recipes linear congruential generator
+uint lcg(inout uint prev)
+{
+    uint LCG_A = 1664525u;
+    uint LCG_C = 1013904223u;
+    prev       = (LCG_A * prev + LCG_C);
+    return prev;
+}
+
+// 4D PCG-style hash. See Jarzynski and Olano, "Hash Functions for GPU Rendering"
+uvec4 pcg4d(uvec4 v)
+{
+    v = v * 1664525u + 1013904223u;
+    v.x += v.y * v.w;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    v.w += v.y * v.z;
+    v ^= v >> 16u;
+    v.x += v.y * v.w;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    v.w += v.y * v.z;
+    return v;
+}
+
+// Philox-4x32. See Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"
+uvec4 philox4x32(uvec4 counter, uvec2 key)
+{
+    for (int i = 0; i < PHILOX_ROUNDS; i++)
+    {
+        uint hi0, lo0, hi1, lo1;
+        umulExtended(0xD2511F53u, counter.x, hi0, lo0);
+        umulExtended(0xCD9E8D57u, counter.z, hi1, lo1);
+        counter = uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key += uvec2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return counter;
+}
+
+// Quasi-random R3 sequence over the particle index, the 3D case of Roberts' generalized golden ratio sequences, in
+// 32-bit fixed point so it matches the CPU exactly. A hashed offset per seed and counter (a Cranley-Patterson rotation)
+// gives every frame and burn-in step its own evenly spread set of points
+uvec4 r3(uint particleIndex, uint seed, uint counter)
+{
+    const uvec3 alpha = uvec3(0xD1B54A33u, 0xABC98389u, 0x8CB92BA7u);
+    const uvec4 offset = pcg4d(uvec4(seed, counter, 0x6A09E667u, 0u));
+    return uvec4(alpha * particleIndex + offset.xyz, offset.w);
+}
+
+// Four random words for a particle, seed and per-particle counter
+uvec4 randomWords(uint particleIndex, uint seed, uint counter)
+{
+#if defined(RNG_PCG)
+    return pcg4d(uvec4(particleIndex, seed, counter, 0x2545F491u));
+#elif defined(RNG_PHILOX)
+    return philox4x32(uvec4(particleIndex, counter, 0u, 0u), uvec2(seed, 0x5851F42Du));
+#elif defined(RNG_R3)
+    return r3(particleIndex, seed, counter);
+#else
+    uint state = tea(particleIndex, seed ^ (counter * 0x9E3779B9u));
+    return uvec4(lcg(state), lcg(state), lcg(state), lcg(state));
+#endif
+}
+
+// Floats in [0, 1) from the top 24 bits of each word
+vec3 randomUnitVec3(uvec4 words)
+{
+    return vec3(words.xyz >> 8u) / float(0x01000000);
+}
@@ -0,0 +1,30 @@
+// Coarse occupancy of the pixel buffer, one bit per TILE_SIZE x TILE_SIZE tile of every layer.
+// Pixels outside a marked tile are always zero, so clearing and resolving can skip unmarked tiles
+
+#define TILE_SIZE 16
+
+layout(std430, binding = 3) restrict buffer TileMaskSSBO
+{
+    uint TileMask[];
+};
+
+uint tileIndex(ivec2 pixelCoord, int layer, ivec2 dimensions)
+{
+    const ivec2 tileCounts = (dimensions + ivec2(TILE_SIZE - 1)) / TILE_SIZE;
+    const ivec2 tile = pixelCoord / TILE_SIZE;
+    return uint((layer * tileCounts.y + tile.y) * tileCounts.x + tile.x);
+}
+
+bool isTileMarked(uint tile)
+{
+    return (TileMask[tile >> 5] & (1u << (tile & 31u))) != 0u;
+}
+
+void markTile(uint tile)
+{
+    // Nearly every splat lands in a tile that is already marked, so only the first few pay for the atomic
+    if (!isTileMarked(tile))
+    {
+        atomicOr(TileMask[tile >> 5], 1u << (tile & 31u));
+    }
+}
@@ -0,0 +1,29 @@
+// Trigonometry of the attractor step, mirrored by Trig.cpp. TRIG_POLYNOMIAL replaces the built-ins with a range reduced
+// odd polynomial, a minimax fit of sin on [-pi/2, pi/2] within 6e-7
+
+#ifdef TRIG_POLYNOMIAL
+float trigSin(float x)
+{
+    // Reduce to [-pi, pi], then fold onto [-pi/2, pi/2] with sin(x) = sin(+-pi - x)
+    x -= 6.2831853 * floor(x * 0.15915494 + 0.5);
+    x = abs(x) > 1.5707963 ? sign(x) * 3.1415927 - x : x;
+
+    const float x2 = x * x;
+    return x * (0.999996616 + x2 * (-0.166648284 + x2 * (0.00830632509 + x2 * -0.0001836365)));
+}
+
+float trigCos(float x)
+{
+    return trigSin(x + 1.5707963);
+}
+#else
+float trigSin(float x)
+{
+    return sin(x);
+}
+
+float trigCos(float x)
+{
+    return cos(x);
+}
+#endif
@@ -0,0 +1,29 @@
+// Uniform blocks shared by every program, matching FrameUniforms and SceneUniforms in UniformBlocks.hpp
+
+#define MAX_VIEWS 6
+
+// Rewritten every frame
+layout(std140, binding = 0) uniform FrameBlock
+{
+    // One view-projection matrix per pixel buffer layer
+    mat4 MVP[MAX_VIEWS];
+    float Time;
+    int Seed;
+};
+
+// Only changes with the scene settings
+layout(std140, binding = 1) uniform SceneBlock
+{
+    vec4 ColdColor;
+    vec4 HotColor;
+    ivec2 RenderTextureDimensions;
+    // Empirical maximum after summing all particle onto a pixel
+    float eMax;
+    // Scales the particle color output by this value
+    float outputScalar;
+    int InstanceCount;
+    // Pixel buffer layers, each RenderTextureDimensions in size
+    int ViewCount;
+    // Layer shown by the output pass, or -1 for a grid of every layer
+    int OutputLayer;
+};
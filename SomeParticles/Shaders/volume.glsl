@@ -0,0 +1,23 @@
+// World space density grid independent of the camera: VolumeResolution^3 hit counts over the cube
+// [-VolumeExtent, VolumeExtent]^3, x fastest
+
+layout(std430, binding = 7) restrict buffer VolumeSSBO
+{
+    uint VolumeCounts[];
+};
+
+uniform int VolumeResolution;
+uniform float VolumeExtent;
+
+// Cell holding a world position, or -1 outside the volume
+int volumeCellIndex(vec3 worldPosition)
+{
+    const vec3 unitPosition = (worldPosition / VolumeExtent) * 0.5 + 0.5;
+    if (any(lessThan(unitPosition, vec3(0.0))) || any(greaterThanEqual(unitPosition, vec3(1.0))))
+    {
+        return -1;
+    }
+
+    const ivec3 cell = ivec3(unitPosition * float(VolumeResolution));
+    return (cell.z * VolumeResolution + cell.y) * VolumeResolution + cell.x;
+}
@@ -0,0 +1,101 @@
+#include "Trig.hpp"
+
+#include <cmath>
+#include <random>
+
+// Side of the square density image, covering [-TRIG_DENSITY_EXTENT, TRIG_DENSITY_EXTENT] in x and y
+#define TRIG_DENSITY_RESOLUTION 64
+#define TRIG_DENSITY_EXTENT 2.5f
+// Iterations before a particle is counted, so the start positions do not show
+#define TRIG_DENSITY_WARMUP 16
+
+std::vector<std::string> GetTrigShaderDefines(const TrigMode mode)
+{
+    switch (mode)
+    {
+        case TrigMode::Shared:
+            return {"TRIG_SHARED"};
+        case TrigMode::Polynomial:
+            return {"TRIG_SHARED", "TRIG_POLYNOMIAL"};
+        case TrigMode::Native:
+        default:
+            return {};
+    }
+}
+
+static float polynomialSin(float x)
+{
+    x -= 6.2831853f * std::floor(x * 0.15915494f + 0.5f);
+    x = std::abs(x) > 1.5707963f ? std::copysign(3.1415927f, x) - x : x;
+
+    const auto x2 = x * x;
+    return x * (0.999996616f + x2 * (-0.166648284f + x2 * (0.00830632509f + x2 * -0.0001836365f)));
+}
+
+float TrigSin(const TrigMode mode, const float x)
+{
+    return mode == TrigMode::Polynomial ? polynomialSin(x) : std::sin(x);
+}
+
+float TrigCos(const TrigMode mode, const float x)
+{
+    return mode == TrigMode::Polynomial ? polynomialSin(x + 1.5707963f) : std::cos(x);
+}
+
+glm::vec3 AttractorStep(const TrigMode mode, const glm::vec3 &pos, const glm::vec4 &attractors)
+{
+    const auto sharedSin = TrigSin(mode, attractors.y * pos.x);
+    const auto nx = TrigSin(mode, attractors.x * pos.y) + attractors.z * TrigCos(mode, attractors.x * pos.x);
+    const auto ny = sharedSin + attractors.w * TrigCos(mode, attractors.y * pos.y);
+    const auto nz = sharedSin + attractors.z * TrigCos(mode, attractors.y * pos.z);
+    return {nx, ny, nz};
+}
+
+static std::vector<double> densityImage(const TrigMode mode, const glm::vec4 &attractors, const int particleCount, const int steps, const unsigned int seed)
+{
+    std::vector<double> image(TRIG_DENSITY_RESOLUTION * TRIG_DENSITY_RESOLUTION, 0.0);
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (int particle = 0; particle < particleCount; particle++)
+    {
+        glm::vec3 pos{distribution(engine), distribution(engine), distribution(engine)};
+        for (int step = 0; step < TRIG_DENSITY_WARMUP + steps; step++)
+        {
+            pos = AttractorStep(mode, pos, attractors);
+            if (step < TRIG_DENSITY_WARMUP)
+            {
+                continue;
+            }
+
+            const auto cell = glm::ivec2(glm::floor((glm::vec2(pos.x, pos.y) / TRIG_DENSITY_EXTENT * 0.5f + 0.5f) * static_cast<float>(TRIG_DENSITY_RESOLUTION)));
+            if (cell.x >= 0 && cell.y >= 0 && cell.x < TRIG_DENSITY_RESOLUTION && cell.y < TRIG_DENSITY_RESOLUTION)
+            {
+                image[cell.y * TRIG_DENSITY_RESOLUTION + cell.x] += 1.0;
+            }
+        }
+    }
+    return image;
+}
+
+static double relativeDistance(const std::vector<double> &image, const std::vector<double> &reference)
+{
+    double difference = 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        difference += std::abs(image[i] - reference[i]);
+        total += reference[i];
+    }
+    return total > 0.0 ? difference / total : 0.0;
+}
+
+TrigAccuracy EvaluateTrigAccuracy(const TrigMode mode, const glm::vec4 &attractors, const int particleCount, const int steps)
+{
+    const auto reference = densityImage(TrigMode::Native, attractors, particleCount, steps, 1u);
+
+    TrigAccuracy accuracy;
+    accuracy.DensityError = relativeDistance(densityImage(mode, attractors, particleCount, steps, 1u), reference);
+    accuracy.NoiseFloor = relativeDistance(densityImage(TrigMode::Native, attractors, particleCount, steps, 2u), reference);
+    return accuracy;
+}
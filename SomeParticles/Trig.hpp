@@ -0,0 +1,40 @@
+#ifndef TRIG_HPP
+#define TRIG_HPP
+
+#include <string>
+#include <vector>
+#include "GLM.hpp"
+
+// CPU mirror of Shaders/trig.glsl and the attractor step in particles.comp
+
+enum class TrigMode
+{
+    // Six built-in sin and cos calls, as written
+    Native,
+    // sin(attractors.y * pos.x) is shared by the y and z terms and evaluated once
+    Shared,
+    // Shared, with the range reduced polynomial in place of the built-ins
+    Polynomial,
+};
+
+// Shader defines selecting the mode in particles.comp and trig.glsl
+std::vector<std::string> GetTrigShaderDefines(TrigMode mode);
+
+float TrigSin(TrigMode mode, float x);
+float TrigCos(TrigMode mode, float x);
+
+glm::vec3 AttractorStep(TrigMode mode, const glm::vec3 &pos, const glm::vec4 &attractors);
+
+// Density images of particleCount particles iterated steps times, compared with the native functions from the same
+// start positions. The orbits soon diverge, so this measures the attractor's shape rather than individual points
+struct TrigAccuracy
+{
+    // Relative L1 distance from the native image
+    double DensityError = 0.0;
+    // The same distance for native functions from other start positions, the sampling noise DensityError sits on
+    double NoiseFloor = 0.0;
+};
+
+TrigAccuracy EvaluateTrigAccuracy(TrigMode mode, const glm::vec4 &attractors, int particleCount, int steps);
+
+#endif //TRIG_HPP
@@ -0,0 +1,52 @@
+#ifndef UNIFORM_BLOCKS_HPP
+#define UNIFORM_BLOCKS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "GLM.hpp"
+
+// Binding points of the blocks in Shaders/uniforms.glsl
+#define FRAME_BLOCK_BINDING 0
+#define SCENE_BLOCK_BINDING 1
+// Largest GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT the slot layout supports
+#define UNIFORM_BLOCK_ALIGNMENT 256
+// Cameras a single dispatch can splat into, enough for a cube map. Must match uniforms.glsl
+#define MAX_VIEWS 6
+
+// std140 FrameBlock
+struct FrameUniforms
+{
+    // One view-projection matrix per pixel buffer layer
+    glm::mat4 MVP[MAX_VIEWS]{};
+    float Time = 0.0f;
+    int32_t Seed = 0;
+    // std140 rounds block sizes up to a multiple of 16 bytes
+    int32_t Padding[2] = {};
+};
+
+// std140 SceneBlock
+struct SceneUniforms
+{
+    glm::vec4 ColdColor{0.0f};
+    glm::vec4 HotColor{0.0f};
+    glm::ivec2 RenderTextureDimensions{0};
+    float EMax = 0.0f;
+    float OutputScalar = 0.0f;
+    int32_t InstanceCount = 0;
+    int32_t ViewCount = 1;
+    // Layer shown by the output pass, or -1 for a grid of every layer
+    int32_t OutputLayer = 0;
+    int32_t Padding = 0;
+};
+
+// Both blocks laid out as one ring buffer slot, so a frame's update is a single copy
+struct UniformSlot
+{
+    alignas(UNIFORM_BLOCK_ALIGNMENT) FrameUniforms Frame;
+    alignas(UNIFORM_BLOCK_ALIGNMENT) SceneUniforms Scene;
+};
+
+static_assert(offsetof(FrameUniforms, Time) == 64 * MAX_VIEWS && offsetof(FrameUniforms, Seed) == 64 * MAX_VIEWS + 4 && sizeof(FrameUniforms) == 64 * MAX_VIEWS + 16);
+static_assert(offsetof(SceneUniforms, RenderTextureDimensions) == 32 && offsetof(SceneUniforms, InstanceCount) == 48 && offsetof(SceneUniforms, OutputLayer) == 56 && sizeof(SceneUniforms) == 64);
+
+#endif //UNIFORM_BLOCKS_HPP
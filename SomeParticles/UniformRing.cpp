@@ -0,0 +1,85 @@
+#include "UniformRing.hpp"
+
+#include <stdexcept>
+#include <string>
+
+UniformRing::UniformRing(const unsigned int slotSize, const unsigned int slotCount) : SlotSize(slotSize), SlotCount(slotCount)
+{
+    int alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0 || SlotSize % static_cast<unsigned int>(alignment) != 0)
+    {
+        throw std::runtime_error("Uniform ring slot size " + std::to_string(SlotSize) + " is not a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT " + std::to_string(alignment));
+    }
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &GLBuffer);
+    glNamedBufferStorage(GLBuffer, static_cast<GLsizeiptr>(SlotSize) * SlotCount, nullptr, flags);
+    mappedPointer = static_cast<char *>(glMapNamedBufferRange(GLBuffer, 0, static_cast<GLsizeiptr>(SlotSize) * SlotCount, flags));
+    if (mappedPointer == nullptr)
+    {
+        glDeleteBuffers(1, &GLBuffer);
+        throw std::runtime_error("Failed to map uniform ring buffer");
+    }
+
+    fences.resize(SlotCount, nullptr);
+    currentSlot = SlotCount - 1;
+}
+
+UniformRing::~UniformRing()
+{
+    for (const auto fence : fences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+        }
+    }
+
+    glUnmapNamedBuffer(GLBuffer);
+    glDeleteBuffers(1, &GLBuffer);
+}
+
+void *UniformRing::Acquire()
+{
+    currentSlot = (currentSlot + 1) % SlotCount;
+
+    auto &fence = fences[currentSlot];
+    if (fence != nullptr)
+    {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    return mappedPointer + GetSlotOffset();
+}
+
+void UniformRing::Release()
+{
+    auto &fence = fences[currentSlot];
+    if (fence != nullptr)
+    {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UniformRing::BindRanges(const unsigned int firstIndex, const std::vector<GLintptr> &offsets, const std::vector<GLsizeiptr> &sizes) const
+{
+    std::vector<GLuint> buffers(offsets.size(), GLBuffer);
+    std::vector<GLintptr> slotOffsets(offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++)
+    {
+        slotOffsets[i] = GetSlotOffset() + offsets[i];
+    }
+
+    glBindBuffersRange(GL_UNIFORM_BUFFER, firstIndex, static_cast<GLsizei>(offsets.size()), buffers.data(), slotOffsets.data(), sizes.data());
+}
+
+unsigned int UniformRing::GetSlotOffset() const
+{
+    return currentSlot * SlotSize;
+}
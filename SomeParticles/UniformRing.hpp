@@ -0,0 +1,37 @@
+#ifndef UNIFORM_RING_HPP
+#define UNIFORM_RING_HPP
+
+#include <vector>
+#include <glad/glad.h>
+
+// A persistently mapped uniform buffer split into slots that are reused round-robin.
+// Each slot is fenced when released, so the CPU never overwrites data the GPU may still be reading
+class UniformRing
+{
+public:
+    UniformRing(unsigned int slotSize, unsigned int slotCount);
+    ~UniformRing();
+
+    UniformRing(const UniformRing &) = delete;
+    UniformRing &operator=(const UniformRing &) = delete;
+
+    unsigned int GLBuffer = 0;
+    const unsigned int SlotSize;
+    const unsigned int SlotCount;
+
+    // Advances to the next slot, waiting for the GPU if it is still in use, and returns its mapping
+    void *Acquire();
+    // Fences the current slot after the commands reading it have been issued
+    void Release();
+
+    // Binds ranges of the current slot to consecutive uniform buffer binding points with one call
+    void BindRanges(unsigned int firstIndex, const std::vector<GLintptr> &offsets, const std::vector<GLsizeiptr> &sizes) const;
+    [[nodiscard]] unsigned int GetSlotOffset() const;
+
+private:
+    char *mappedPointer = nullptr;
+    unsigned int currentSlot = 0;
+    std::vector<GLsync> fences;
+};
+
+#endif //UNIFORM_RING_HPP
@@ -0,0 +1,67 @@
+#include "Views.hpp"
+
+#include <algorithm>
+#include "UniformBlocks.hpp"
+
+int GetViewCount(const ViewMode mode, const int orbitViewCount)
+{
+    switch (mode)
+    {
+        case ViewMode::Stereo:
+            return 2;
+        case ViewMode::Orbit:
+            return std::clamp(orbitViewCount, 1, MAX_VIEWS);
+        case ViewMode::CubeMap:
+            return 6;
+        case ViewMode::Single:
+        default:
+            return 1;
+    }
+}
+
+std::vector<glm::mat4> GetViewMatrices(const ViewMode mode, const int orbitViewCount, const glm::mat4 &projection, const float aspect, const glm::vec3 &eyePos, const float stereoSeparation)
+{
+    const glm::vec3 up{0.0f, 1.0f, 0.0f};
+    const glm::vec3 target{0.0f, 0.0f, 0.0f};
+
+    std::vector<glm::mat4> matrices;
+    switch (mode)
+    {
+        case ViewMode::Stereo:
+        {
+            const auto right = glm::normalize(glm::cross(target - eyePos, up)) * (stereoSeparation * 0.5f);
+            matrices.push_back(projection * glm::lookAt(eyePos - right, target - right, up));
+            matrices.push_back(projection * glm::lookAt(eyePos + right, target + right, up));
+            break;
+        }
+        case ViewMode::Orbit:
+        {
+            const auto count = GetViewCount(mode, orbitViewCount);
+            for (int i = 0; i < count; i++)
+            {
+                const auto rotation = glm::rotate(glm::mat4{1.0f}, glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(count), up);
+                matrices.push_back(projection * glm::lookAt(glm::vec3(rotation * glm::vec4(eyePos, 1.0f)), target, up));
+            }
+            break;
+        }
+        case ViewMode::CubeMap:
+        {
+            // Squeezes the square face along the longer side of the layer, leaving the margins empty
+            const glm::vec3 squareScale{std::min(1.0f / aspect, 1.0f), std::min(aspect, 1.0f), 1.0f};
+            const auto faceProjection = glm::scale(glm::mat4{1.0f}, squareScale) * glm::perspective(glm::radians(90.0f), 1.0f, 0.01f, 100.0f);
+            const glm::vec3 directions[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+            const glm::vec3 ups[6] = {{0, -1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}};
+            for (int i = 0; i < 6; i++)
+            {
+                matrices.push_back(faceProjection * glm::lookAt(eyePos, eyePos + directions[i], ups[i]));
+            }
+            break;
+        }
+        case ViewMode::Single:
+        default:
+            matrices.push_back(projection * glm::lookAt(eyePos, target, up));
+            break;
+    }
+
+    return matrices;
+}
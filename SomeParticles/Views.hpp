@@ -0,0 +1,26 @@
+#ifndef VIEWS_HPP
+#define VIEWS_HPP
+
+#include <cstdint>
+#include <vector>
+#include "GLM.hpp"
+
+// How the cameras splatted into by one dispatch are arranged. Stored in checkpoints
+enum class ViewMode : uint32_t
+{
+    Single = 0,
+    // Left and right eye, offset along the camera's right vector
+    Stereo = 1,
+    // Cameras evenly spaced around the Y axis at the eye distance
+    Orbit = 2,
+    // Six 90 degree faces from the eye position, in GL cube map face order
+    CubeMap = 3,
+};
+
+int GetViewCount(ViewMode mode, int orbitViewCount);
+
+// View-projection matrix of each layer. projection is the main camera's and is used by every mode but the cube map,
+// whose faces fill the largest centred square of each layer of the given aspect ratio so their pixels stay square
+std::vector<glm::mat4> GetViewMatrices(ViewMode mode, int orbitViewCount, const glm::mat4 &projection, float aspect, const glm::vec3 &eyePos, float stereoSeparation);
+
+#endif //VIEWS_HPP
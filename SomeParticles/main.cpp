@@ -1,14 +1,38 @@
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <thread>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
-
+#include <misc/cpp/imgui_stdlib.h>
+
+#include "Attractor.hpp"
+#include "Checkpoint.hpp"
+#include "Distributed.hpp"
+#include "GLState.hpp"
+#include "Golden.hpp"
+#include "Json.hpp"
+#include "PixelLayout.hpp"
+#include "Poster.hpp"
+#include "Random.hpp"
 #include "Shader.hpp"
+#include "Trig.hpp"
+#include "UniformBlocks.hpp"
+#include "UniformRing.hpp"
+#include "Views.hpp"
 
 #define INITIAL_WIDTH 1600
 #define INITIAL_HEIGHT 900
@@ -26,31 +50,287 @@ extern "C" const size_t output_frag_size;
 
 extern "C" const char particles_comp[];
 extern "C" const size_t particles_comp_size;
+
+extern "C" const char uniforms_glsl[];
+extern "C" const size_t uniforms_glsl_size;
+
+extern "C" const char random_glsl[];
+extern "C" const size_t random_glsl_size;
+
+extern "C" const char tiles_glsl[];
+extern "C" const size_t tiles_glsl_size;
+
+extern "C" const char pixel_index_glsl[];
+extern "C" const size_t pixel_index_glsl_size;
+
+extern "C" const char volume_glsl[];
+extern "C" const size_t volume_glsl_size;
+
+extern "C" const char volume_comp[];
+extern "C" const size_t volume_comp_size;
+
+extern "C" const char trig_glsl[];
+extern "C" const size_t trig_glsl_size;
+
+extern "C" const char clear_comp[];
+extern "C" const size_t clear_comp_size;
+
+extern "C" const char instances_glsl[];
+extern "C" const size_t instances_glsl_size;
+
+extern "C" const char sort_comp[];
+extern "C" const size_t sort_comp_size;
+
+extern "C" const char budget_comp[];
+extern "C" const size_t budget_comp_size;
+
+extern "C" const char decay_comp[];
+extern "C" const size_t decay_comp_size;
 #endif
 
+// Frames in flight that can each own a slot of the uniform ring
+#define UNIFORM_RING_SLOTS 3
+
+// Deterministic mode derives the seed from the frame index and advances time by a fixed step
+#define DETERMINISTIC_SEED 0x5EEDu
+#define DETERMINISTIC_FRAME_TIME (1.0f / 60.0f)
+
+// Reference scenes rendered by --regression, small enough to run on a software rasterizer
+#define REGRESSION_WIDTH 640
+#define REGRESSION_HEIGHT 360
+#define REGRESSION_DISPATCH glm::ivec3(16, 16, 8)
+#define REGRESSION_FRAMES 32
+// eMax of a single frame, scaled by the frames so the densest pixels stay well clear of overflowing their channels.
+// Overflowed channels wrap with the exact hit count, which renders on other GPUs or the CPU mirror do not share
+#define REGRESSION_EMAX 4000.0f
+// Exit code of --regression when there are no goldens to compare with, which CTest reports as skipped
+#define REGRESSION_SKIPPED 77
+
+// Whether --regression compares with the goldens, or rewrites them from the GPU or the CPU mirror of the splat
+enum class GoldenUpdate
+{
+    None,
+    Gpu,
+    Cpu,
+};
+
 static float deltaTime = 0.0f;
 
 static std::shared_ptr<ShaderProgram> particlesProgram;
+static std::shared_ptr<ShaderProgram> burnInProgram;
 static std::shared_ptr<ShaderProgram> outputProgram;
+static std::shared_ptr<ShaderProgram> clearProgram;
+static std::shared_ptr<ShaderProgram> sortKeysProgram;
+static std::shared_ptr<ShaderProgram> sortScanProgram;
+static std::shared_ptr<ShaderProgram> sortScatterProgram;
+static std::shared_ptr<ShaderProgram> volumeProgram;
+static std::shared_ptr<ShaderProgram> respawnProgram;
+static std::shared_ptr<ShaderProgram> budgetProgram;
+static std::shared_ptr<ShaderProgram> decayProgram;
 static std::shared_ptr<SSBO> uintPixels;
 static std::shared_ptr<SSBO> particleBuffer;
+static std::shared_ptr<SSBO> instanceBuffer;
 static glm::ivec2 particleSize{INITIAL_WIDTH, INITIAL_HEIGHT};
 static glm::ivec3 dispatchSize{64, 32, 16};
 
+// CPU copy of the uniform blocks, copied into the next ring slot at the start of each frame
+static UniformSlot uniforms;
+static std::unique_ptr<UniformRing> uniformRing;
+
 static glm::mat4 projection{1.0f};
 static glm::mat4 view{1.0f};
 static glm::vec3 eyePos{1.5f, 5.0f, 5.0f};
 static bool animateEyePos = false;
 static bool animatedEyePosNormalize = false;
 
+// Every view is splatted by the same dispatch into its own layer of the pixel buffer
+static ViewMode viewMode = ViewMode::Single;
+static int orbitViewCount = 4;
+static float stereoSeparation = 0.3f;
+static int outputLayer = -1;
+
 static float particleEMax = 1000.0f;
 static float outputScalar = 5.0f;
 
+// Progressive rendering keeps summing into the pixel buffer instead of clearing it each frame
+static bool accumulatePixels = false;
+static uint64_t accumulatedFrames = 0;
+
+// Temporal decay keeps a float history of the splats that fades by decayFactor each frame, and writes it back over the
+// freshly splatted pixel buffer at one frame's brightness, so the image averages several frames of samples. Only used
+// while not accumulating. See Shaders/decay.comp
+static bool temporalDecay = false;
+static float decayFactor = 0.9f;
+// Sum of the frame weights in the history, approaching 1 / (1 - decayFactor)
+static double decayWeight = 0.0;
+static std::shared_ptr<SSBO> decayHistory;
+
+// Pipelined mode splats each frame into the next of several pixel buffers while the output pass resolves the buffer
+// finished last frame, so the two passes overlap on the GPU at the cost of a frame of latency. Accumulating and posters
+// always use a single buffer. uintPixels is the buffer being splatted into
+#define MAX_PIXEL_BUFFERS 4
+static bool pipelinePixels = false;
+static int pixelBufferCount = 2;
+static std::vector<std::shared_ptr<SSBO>> pixelBuffers;
+// Fenced after the output pass that last read each buffer, so it is not cleared while still being resolved
+static std::vector<GLsync> pixelBufferFences;
+static int pixelBufferIndex = 0;
+
+// Tile occupancy masks paired with pixelBuffers, see Shaders/tiles.glsl. With dirty tiles on, clearing and the output
+// pass skip the tiles nothing was splatted into. tileMask belongs to uintPixels
+#define DIRTY_TILE_SIZE 16
+static bool dirtyTiles = true;
+static std::vector<std::shared_ptr<SSBO>> tileMasks;
+static std::shared_ptr<SSBO> tileMask;
+
+// Order of the pixels within the pixel buffers. CPU readbacks go through readPixels so they always see row-major pixels
+static PixelLayout pixelLayout = PixelLayout::RowMajor;
+
+// Offline render of an image larger than the pixel buffer, one tile per frame with the same seed sequence for every tile
+struct PosterRender
+{
+    std::unique_ptr<TiledTiffWriter> Writer;
+    glm::mat4 ViewProjection{1.0f};
+    float EMax = 0.0f;
+    int FramesPerTile = 1;
+    int NextTile = 0;
+
+    // Restored once the poster is finished
+    glm::ivec2 SavedParticleSize{0};
+    ViewMode SavedViewMode = ViewMode::Single;
+    bool SavedAccumulatePixels = false;
+    bool SavedDeterministic = false;
+    bool SavedAnimateEyePos = false;
+    int SavedBurnInStepsPerFrame = 0;
+};
+
+static std::unique_ptr<PosterRender> poster;
+static std::string posterPath = "poster.tif";
+static glm::ivec2 posterSize{16384, 16384};
+static int posterTileSize = 2048;
+static int posterFramesPerTile = 16;
+static std::string posterStatus;
+
+static std::unique_ptr<CheckpointWriter> checkpointWriter;
+static std::string checkpointPath = "checkpoint.spck";
+static std::string checkpointStatus;
+
 static std::default_random_engine randomEngine(std::random_device{}());
 static std::uniform_int_distribution<unsigned short> particleSeedDistribution;
 static int particleSeed = 1;
 
-static glm::vec4 attractors{-1.4f, 1.6f, 1.0f, 0.7f};
+static bool deterministic = false;
+static uint32_t deterministicFrame = 0;
+
+// Generator used to place respawned particles, see Shaders/random.glsl
+static RandomGenerator randomGenerator = RandomGenerator::TEA;
+static int teaRounds = 16;
+static std::string randomQualityStatus;
+
+// Number of particles compared against the CPU mirror by the RNG check
+#define RANDOM_PARITY_SAMPLES 4096
+
+// Implementation of the attractor step's sin and cos, see Shaders/trig.glsl
+static TrigMode trigMode = TrigMode::Native;
+static std::string trigBenchmarkStatus;
+// Size of the CPU mirror's density images in the trig benchmark
+#define TRIG_BENCHMARK_PARTICLES 16384
+#define TRIG_BENCHMARK_STEPS 64
+
+// Every instance is simulated by the same dispatch, each over its own range of particles
+static std::vector<AttractorInstanceSettings> attractorInstances{AttractorInstanceSettings{}};
+static std::vector<AttractorInstance> instanceRows;
+
+// Burn-in iterates particles onto the attractor without splatting, split over frames by burnInStepsPerFrame
+static int burnInSteps = 64;
+static int burnInStepsPerFrame = 64;
+static int burnInStepsTotal = 0;
+static int burnInStepsRemaining = 0;
+
+// Warm continuation keeps an instance's particles when its parameters change, so the new map carries them over from the
+// old attractor and only those that escape respawn. continuationBurnInSteps then settles them before splatting resumes
+static bool warmContinuation = false;
+static int continuationBurnInSteps = 4;
+
+// GL_KHR_shader_subgroup is not in the glad loader
+#ifndef GL_SUBGROUP_SUPPORTED_STAGES_KHR
+#define GL_SUBGROUP_SUPPORTED_STAGES_KHR 0x9533
+#define GL_SUBGROUP_SUPPORTED_FEATURES_KHR 0x9534
+#define GL_SUBGROUP_FEATURE_BASIC_BIT_KHR 0x00000001
+#define GL_SUBGROUP_FEATURE_ARITHMETIC_BIT_KHR 0x00000004
+#define GL_SUBGROUP_FEATURE_BALLOT_BIT_KHR 0x00000008
+#endif
+
+// Splats on the same pixel within a subgroup are summed and added with one atomic, where the driver supports it
+static bool subgroupAggregation = true;
+static bool subgroupAggregationSupported = false;
+
+// Escaped particles are appended to a queue by the splat dispatch and seeded by a separate indirect dispatch, instead of
+// spawning inline. Header of four words, the indirect dispatch arguments and the entry count, then one word per particle
+#define RESPAWN_QUEUE_HEADER_SIZE (4 * sizeof(uint32_t))
+static bool respawnQueue = false;
+static std::shared_ptr<SSBO> respawnQueueBuffer;
+
+// Time slicing splats only a slice of the z layers of work groups each frame, sized so the splat stays within
+// sliceBudget milliseconds of GPU time, and rotates the slice so every particle is advanced every few frames.
+// Timer queries are read a few frames late so the CPU never waits on them
+#define SLICE_QUERY_COUNT 4
+static bool timeSlicing = false;
+static float sliceBudget = 8.0f;
+static int sliceLayers = 1;
+static int sliceFirstLayer = 0;
+// Smoothed GPU milliseconds per z layer, or zero until the first measurement
+static double sliceLayerMilliseconds = 0.0;
+static GLuint sliceQueries[SLICE_QUERY_COUNT] = {};
+static int sliceQueryLayers[SLICE_QUERY_COUNT] = {};
+static int sliceQueryIndex = 0;
+
+// The adaptive budget splats only the first z layers of the dispatch grid, as many as keep each frame's GPU time near
+// budgetTarget milliseconds, and brightens them to make up for the rest. The timer query of each frame is copied into
+// budgetBuffer on the GPU and turned into the next splat's indirect dispatch by Shaders/budget.comp, so the CPU never
+// reads it back. Takes the place of time slicing while on
+static bool adaptiveBudget = false;
+static float budgetTarget = 12.0f;
+static std::shared_ptr<SSBO> budgetBuffer;
+// Alternating, so last frame's query is copied while this frame's is running
+static GLuint budgetQueries[2] = {};
+static int budgetQueryIndex = 0;
+// Set once the query not in use this frame holds a budgeted frame's time
+static bool budgetQueryPending = false;
+
+// std430 BudgetSSBO in Shaders/budget.comp
+struct BudgetState
+{
+    uint32_t Dispatch[3] = {};
+    float Layers = 0.0f;
+    uint64_t Elapsed = 0;
+};
+
+static_assert(offsetof(BudgetState, Elapsed) == 16 && sizeof(BudgetState) == 24);
+
+// Every sortInterval frames the particles are reordered by the screen cell they land in, so neighbouring invocations
+// splat into neighbouring pixels. 0 turns sorting off. See Shaders/sort.comp
+#define SORT_BUCKETS_PER_INSTANCE (64 * 64)
+// Splat dispatches timed on each side of the sort by the sort benchmark
+#define SORT_BENCHMARK_FRAMES 16
+static int sortInterval = 0;
+static int framesSinceSort = 0;
+static std::shared_ptr<SSBO> sortKeys;
+static std::shared_ptr<SSBO> sortBuckets;
+static std::shared_ptr<SSBO> sortedParticles;
+static std::string sortBenchmarkStatus;
+
+// Density volume mode counts particle hits into a world space grid instead of the pixel buffer, then ray-marches every
+// view from it, so moving the camera keeps everything accumulated so far. See Shaders/volume.comp
+#define MAX_VOLUME_RESOLUTION 512
+static bool densityVolume = false;
+static int volumeResolution = 256;
+static float volumeExtent = 2.5f;
+static float volumeGain = 1.0f;
+// Stops simulating, leaving only the ray-march, to move around a converged volume
+static bool volumeFrozen = false;
+static uint64_t volumeFrames = 0;
+static std::shared_ptr<SSBO> volumeBuffer;
 
 static glm::vec3 coldColor{0.25f, 0.25f, 1.0f};
 static glm::vec3 hotColor{1.0f, 0.25f, 0.25f};
@@ -62,10 +342,34 @@ static std::vector<glm::vec4> attractorPresets{
     {-1.8f, -2.0f, -0.5f, -0.9f},
 };
 
-static bool showUI = true;
+static glm::ivec2 getTileCounts()
+{
+    return (particleSize + glm::ivec2(DIRTY_TILE_SIZE - 1)) / DIRTY_TILE_SIZE;
+}
+
+// One bit per tile of every layer
+static size_t getTileMaskWordCount()
+{
+    const auto tileCounts = getTileCounts();
+    return (static_cast<size_t>(tileCounts.x) * tileCounts.y * GetViewCount(viewMode, orbitViewCount) + 31) / 32;
+}
 
 static void clearPixelSSBO()
 {
+    if (dirtyTiles && clearProgram != nullptr)
+    {
+        // Zero only the marked tiles, then the marks themselves
+        const auto tileCounts = getTileCounts();
+        clearProgram->Use();
+        clearProgram->SetIVec2("PixelDimensions", particleSize);
+        glDispatchCompute(tileCounts.x, tileCounts.y, GetViewCount(viewMode, orbitViewCount));
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        tileMask->Bind();
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        return;
+    }
+
     uintPixels->Bind();
     glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_RG32UI, GL_RG, GL_UNSIGNED_INT, nullptr);
 }
@@ -76,377 +380,3216 @@ static void clearParticlesSSBO()
     glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, nullptr);
 }
 
+// Empties the density volume, keeping its allocation
+static void clearVolume()
+{
+    volumeFrames = 0;
+    if (volumeBuffer != nullptr)
+    {
+        volumeBuffer->Bind();
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+}
+
+static void requestBurnIn()
+{
+    burnInStepsTotal = std::max(burnInSteps, 0);
+    burnInStepsRemaining = burnInStepsTotal;
+    // The volume holds the hits of the particles being restarted
+    clearVolume();
+}
+
+// Never shortens a burn-in that is already under way
+static void requestContinuationBurnIn()
+{
+    if (continuationBurnInSteps > burnInStepsRemaining)
+    {
+        burnInStepsTotal = continuationBurnInSteps;
+        burnInStepsRemaining = continuationBurnInSteps;
+    }
+    clearVolume();
+}
+
 static void updateColors()
 {
-    if (outputProgram != nullptr)
+    uniforms.Scene.ColdColor = glm::vec4(coldColor, 1.0f);
+    uniforms.Scene.HotColor = glm::vec4(hotColor, 1.0f);
+}
+
+static size_t getParticleCount(const glm::ivec3 &size = dispatchSize)
+{
+    return static_cast<size_t>(16 * 16 * 1) * (static_cast<size_t>(size.x * size.y) * size.z);
+}
+
+static void clearParticleRange(const size_t first, const size_t count)
+{
+    if (count == 0)
     {
-        outputProgram->SetVec3("ColdColor", coldColor);
-        outputProgram->SetVec3("HotColor", hotColor);
+        return;
     }
+
+    particleBuffer->Bind();
+    glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32F, first * sizeof(glm::vec4), count * sizeof(glm::vec4), GL_RGBA, GL_FLOAT, nullptr);
 }
 
-static void updateAttractors()
+static AttractorInstance makeInstanceRow(const AttractorInstanceSettings &settings, const glm::uvec4 &range)
 {
-    clearParticlesSSBO();
+    AttractorInstance row;
+    row.Parameters = settings.Parameters;
+    row.Transform = settings.GetTransform();
+    row.Color = glm::vec4(settings.Color, 1.0f);
+    row.Range = range;
+    return row;
+}
 
-    if (particlesProgram != nullptr)
+static void setInstanceUniforms()
+{
+    uniforms.Scene.InstanceCount = static_cast<int32_t>(instanceRows.size());
+
+    for (const auto &program : {particlesProgram, burnInProgram, sortKeysProgram})
+    {
+        if (program != nullptr)
+        {
+            program->SetSSBO("InstanceBufferSSBO", instanceBuffer);
+        }
+    }
+}
+
+// Splits the particles between the instances by weight and uploads the whole table
+static void rebuildInstanceTable()
+{
+    const auto particleCount = getParticleCount();
+    const auto instanceCount = attractorInstances.size();
+
+    float totalWeight = 0.0f;
+    for (const auto &settings : attractorInstances)
+    {
+        totalWeight += std::max(settings.Weight, 0.0f);
+    }
+
+    instanceRows.resize(instanceCount);
+    size_t first = 0;
+    for (size_t i = 0; i < instanceCount; i++)
     {
-        particlesProgram->SetVec4("attractors", attractors);
+        const auto &settings = attractorInstances[i];
+
+        size_t count;
+        if (i == instanceCount - 1)
+        {
+            count = particleCount - first;
+        }
+        else if (totalWeight > 0.0f)
+        {
+            count = static_cast<size_t>(static_cast<double>(particleCount) * std::max(settings.Weight, 0.0f) / totalWeight);
+        }
+        else
+        {
+            count = particleCount / instanceCount;
+        }
+        count = std::min(count, particleCount - first);
+
+        instanceRows[i] = makeInstanceRow(settings, glm::uvec4(first, count, 0, 0));
+        first += count;
     }
+
+    instanceBuffer->Update(instanceRows);
+    setInstanceUniforms();
 }
 
-static size_t getParticleCount()
+// Uploads only the changed row, restarting just that instance's particles when its parameters changed unless
+// continuing them warm
+static void updateInstance(const int index, const bool parametersChanged)
 {
-    return static_cast<size_t>(16 * 16 * 1) * (static_cast<size_t>(dispatchSize.x * dispatchSize.y) * dispatchSize.z);
+    auto &row = instanceRows.at(index);
+    row = makeInstanceRow(attractorInstances.at(index), row.Range);
+    instanceBuffer->UpdateRange(index * sizeof(AttractorInstance), &row, sizeof(AttractorInstance));
+
+    if (parametersChanged && warmContinuation)
+    {
+        requestContinuationBurnIn();
+    }
+    else if (parametersChanged)
+    {
+        clearParticleRange(row.Range.x, row.Range.y);
+        requestBurnIn();
+    }
 }
 
-static void reloadShaders()
+// For changes to the set of instances or their weights, which move the particle ranges
+static void updateAttractors()
+{
+    clearParticlesSSBO();
+    requestBurnIn();
+    rebuildInstanceTable();
+}
+
+// Compiles every shader variant for the current settings, leaving the programs unbound. Returns false and resets the
+// programs if any of them failed
+static bool compileShaders()
 {
+    auto randomDefines = GetRandomShaderDefines(randomGenerator, teaRounds);
+    const auto trigDefines = GetTrigShaderDefines(trigMode);
+    randomDefines.insert(randomDefines.end(), trigDefines.begin(), trigDefines.end());
+    auto burnInDefines = randomDefines;
+    burnInDefines.emplace_back("BURN_IN");
+    std::vector<std::string> outputDefines;
+    std::vector<std::string> clearDefines;
+    const std::vector<std::string> sortKeysDefines{"SORT_KEYS"};
+    const std::vector<std::string> sortScanDefines{"SORT_SCAN"};
+    const std::vector<std::string> sortScatterDefines{"SORT_SCATTER"};
+    if (dirtyTiles)
+    {
+        randomDefines.emplace_back("DIRTY_TILES");
+        outputDefines.emplace_back("DIRTY_TILES");
+    }
+    if (subgroupAggregation && subgroupAggregationSupported)
+    {
+        randomDefines.emplace_back("SUBGROUP_AGGREGATION");
+    }
+    if (densityVolume)
+    {
+        randomDefines.emplace_back("DENSITY_VOLUME");
+    }
+    // Seeds with the same generator as the splat
+    auto respawnDefines = randomDefines;
+    respawnDefines.emplace_back("RESPAWN");
+    if (respawnQueue)
+    {
+        randomDefines.emplace_back("RESPAWN_QUEUE");
+    }
+    if (adaptiveBudget)
+    {
+        randomDefines.emplace_back("ADAPTIVE_BUDGET");
+    }
+    else if (timeSlicing)
+    {
+        randomDefines.emplace_back("TIME_SLICED");
+    }
+    if (pixelLayout == PixelLayout::Morton)
+    {
+        randomDefines.emplace_back("PIXEL_LAYOUT_MORTON");
+        outputDefines.emplace_back("PIXEL_LAYOUT_MORTON");
+        clearDefines.emplace_back("PIXEL_LAYOUT_MORTON");
+    }
+    // Writes the same pixels and tiles as the splat
+    std::vector<std::string> volumeDefines = outputDefines;
+    std::vector<std::string> decayDefines = outputDefines;
+
     try
     {
 #ifdef EMBEDDED_SHADERS
-        auto particles = std::make_shared<Shader>(ShaderType::Compute, std::string(particles_comp, particles_comp_size));
+        RegisterShaderSource("uniforms.glsl", std::string(uniforms_glsl, uniforms_glsl_size));
+        RegisterShaderSource("random.glsl", std::string(random_glsl, random_glsl_size));
+        RegisterShaderSource("tiles.glsl", std::string(tiles_glsl, tiles_glsl_size));
+        RegisterShaderSource("pixel_index.glsl", std::string(pixel_index_glsl, pixel_index_glsl_size));
+        RegisterShaderSource("instances.glsl", std::string(instances_glsl, instances_glsl_size));
+        RegisterShaderSource("trig.glsl", std::string(trig_glsl, trig_glsl_size));
+        RegisterShaderSource("volume.glsl", std::string(volume_glsl, volume_glsl_size));
+
+        auto particles = std::make_shared<Shader>(ShaderType::Compute, std::string(particles_comp, particles_comp_size), randomDefines);
         particlesProgram = std::make_shared<ShaderProgram>(particles);
 
+        auto burnIn = std::make_shared<Shader>(ShaderType::Compute, std::string(particles_comp, particles_comp_size), burnInDefines);
+        burnInProgram = std::make_shared<ShaderProgram>(burnIn);
+
+        auto respawn = std::make_shared<Shader>(ShaderType::Compute, std::string(particles_comp, particles_comp_size), respawnDefines);
+        respawnProgram = std::make_shared<ShaderProgram>(respawn);
+
         auto outputVert = std::make_shared<Shader>(ShaderType::Vertex, std::string(output_vert, output_vert_size));
-        auto outputFrag = std::make_shared<Shader>(ShaderType::Fragment, std::string(output_frag, output_frag_size));
+        auto outputFrag = std::make_shared<Shader>(ShaderType::Fragment, std::string(output_frag, output_frag_size), outputDefines);
         outputProgram = std::make_shared<ShaderProgram>(outputVert, outputFrag);
+
+        auto clear = std::make_shared<Shader>(ShaderType::Compute, std::string(clear_comp, clear_comp_size), clearDefines);
+        clearProgram = std::make_shared<ShaderProgram>(clear);
+
+        const std::string sortSource(sort_comp, sort_comp_size);
+        sortKeysProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, sortSource, sortKeysDefines));
+        sortScanProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, sortSource, sortScanDefines));
+        sortScatterProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, sortSource, sortScatterDefines));
+
+        volumeProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, std::string(volume_comp, volume_comp_size), volumeDefines));
+
+        budgetProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, std::string(budget_comp, budget_comp_size)));
+
+        decayProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>(ShaderType::Compute, std::string(decay_comp, decay_comp_size), decayDefines));
 #else
-        auto particles = std::make_shared<Shader>("particles.comp", ShaderType::Compute);
+        auto particles = std::make_shared<Shader>("particles.comp", ShaderType::Compute, randomDefines);
         particlesProgram = std::make_shared<ShaderProgram>(particles);
 
+        auto burnIn = std::make_shared<Shader>("particles.comp", ShaderType::Compute, burnInDefines);
+        burnInProgram = std::make_shared<ShaderProgram>(burnIn);
+
+        auto respawn = std::make_shared<Shader>("particles.comp", ShaderType::Compute, respawnDefines);
+        respawnProgram = std::make_shared<ShaderProgram>(respawn);
+
         auto outputVert = std::make_shared<Shader>("output.vert", ShaderType::Vertex);
-        auto outputFrag = std::make_shared<Shader>("output.frag", ShaderType::Fragment);
+        auto outputFrag = std::make_shared<Shader>("output.frag", ShaderType::Fragment, outputDefines);
         outputProgram = std::make_shared<ShaderProgram>(outputVert, outputFrag);
+
+        auto clear = std::make_shared<Shader>("clear.comp", ShaderType::Compute, clearDefines);
+        clearProgram = std::make_shared<ShaderProgram>(clear);
+
+        sortKeysProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("sort.comp", ShaderType::Compute, sortKeysDefines));
+        sortScanProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("sort.comp", ShaderType::Compute, sortScanDefines));
+        sortScatterProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("sort.comp", ShaderType::Compute, sortScatterDefines));
+
+        volumeProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("volume.comp", ShaderType::Compute, volumeDefines));
+
+        budgetProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("budget.comp", ShaderType::Compute));
+
+        decayProgram = std::make_shared<ShaderProgram>(std::make_shared<Shader>("decay.comp", ShaderType::Compute, decayDefines));
 #endif
     }
     catch (const std::exception &e)
     {
         particlesProgram.reset();
+        burnInProgram.reset();
         outputProgram.reset();
+        clearProgram.reset();
+        sortKeysProgram.reset();
+        sortScanProgram.reset();
+        sortScatterProgram.reset();
+        volumeProgram.reset();
+        respawnProgram.reset();
+        budgetProgram.reset();
+        decayProgram.reset();
         std::cerr << e.what() << '\n';
-        return;
+        return false;
     }
+    return true;
+}
+
+static void reloadShaders()
+{
+    if (compileShaders())
+    {
+        updateAttractors();
+        updateColors();
+    }
+}
+
+static void bindPixelsSSBO()
+{
+    uniforms.Scene.RenderTextureDimensions = particleSize;
+    uniforms.Scene.EMax = particleEMax;
+    uniforms.Scene.OutputScalar = outputScalar;
 
     if (particlesProgram != nullptr)
     {
-        particlesProgram->SetMat4("MVP", projection * view);
+        particlesProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        particlesProgram->SetSSBO("TileMaskSSBO", tileMask);
     }
 
-    updateAttractors();
-    updateColors();
+    if (outputProgram != nullptr)
+    {
+        outputProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        outputProgram->SetSSBO("TileMaskSSBO", tileMask);
+    }
+
+    if (clearProgram != nullptr)
+    {
+        clearProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        clearProgram->SetSSBO("TileMaskSSBO", tileMask);
+    }
+
+    if (volumeProgram != nullptr)
+    {
+        volumeProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        volumeProgram->SetSSBO("TileMaskSSBO", tileMask);
+    }
+
+    if (decayProgram != nullptr)
+    {
+        decayProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        decayProgram->SetSSBO("TileMaskSSBO", tileMask);
+        decayProgram->SetSSBO("DecayHistorySSBO", decayHistory);
+    }
+}
+
+static void bindVolumeSSBO()
+{
+    for (const auto &program : {particlesProgram, volumeProgram})
+    {
+        if (program != nullptr)
+        {
+            program->SetSSBO("VolumeSSBO", volumeBuffer);
+            program->SetInt("VolumeResolution", volumeResolution);
+            program->SetFloat("VolumeExtent", volumeExtent);
+        }
+    }
+}
+
+// Allocates an empty volume while the mode is on, and frees it otherwise
+static void recreateVolumeSSBO()
+{
+    if (densityVolume)
+    {
+        if (volumeBuffer == nullptr)
+        {
+            volumeBuffer = std::make_shared<SSBO>();
+        }
+        const auto cellCount = static_cast<size_t>(volumeResolution) * volumeResolution * volumeResolution;
+        volumeBuffer->Update(nullptr, cellCount * sizeof(uint32_t));
+        clearVolume();
+    }
+    else
+    {
+        volumeBuffer.reset();
+    }
+    bindVolumeSSBO();
+}
+
+// An empty history the size of the pixel buffer while decay is on, freed otherwise
+static void recreateDecaySSBO()
+{
+    decayWeight = 0.0;
+    if (temporalDecay)
+    {
+        if (decayHistory == nullptr)
+        {
+            decayHistory = std::make_shared<SSBO>();
+        }
+        const auto pixelCount = GetPixelBufferLength(pixelLayout, particleSize.x, particleSize.y, GetViewCount(viewMode, orbitViewCount));
+        decayHistory->Update(nullptr, pixelCount * sizeof(glm::vec4));
+        decayHistory->Bind();
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, nullptr);
+    }
+    else
+    {
+        decayHistory.reset();
+    }
 }
 
 static void recreatePixelsSSBO()
 {
     {
-        const auto pixelCount = particleSize.x * particleSize.y;
+        const auto pixelCount = GetPixelBufferLength(pixelLayout, particleSize.x, particleSize.y, GetViewCount(viewMode, orbitViewCount));
         const auto pixels = new uint64_t[pixelCount];
         memset(pixels, 0, pixelCount * sizeof(uint64_t));
-        uintPixels->Update(pixels, pixelCount * sizeof(uint64_t));
+        const std::vector<uint32_t> tileWords(getTileMaskWordCount(), 0u);
+        // Only the first buffer is kept allocated unless pipelining
+        for (size_t i = 0; i < pixelBuffers.size(); i++)
+        {
+            const auto used = i == 0 || (pipelinePixels && static_cast<int>(i) < pixelBufferCount);
+            pixelBuffers[i]->Update(used ? pixels : nullptr, used ? pixelCount * sizeof(uint64_t) : 0);
+            tileMasks[i]->Update(used ? tileWords.data() : nullptr, used ? tileWords.size() * sizeof(uint32_t) : 0);
+        }
         delete[] pixels;
     }
+    pixelBufferIndex = 0;
+    uintPixels = pixelBuffers.front();
+    tileMask = tileMasks.front();
+    accumulatedFrames = 0;
+    recreateDecaySSBO();
+
+    bindPixelsSSBO();
+}
+
+static bool isPipelined()
+{
+    // The volume resolve rewrites the whole buffer, leaving no splat to overlap with
+    return pipelinePixels && !accumulatePixels && !densityVolume && poster == nullptr;
+}
+
+// Moves the splat to the next pixel buffer once the GPU has finished resolving it, and points the output pass at the
+// buffer splatted last frame. The barrier makes last frame's splats visible without waiting for this frame's
+static void advancePixelBuffer()
+{
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    const auto count = std::clamp(pixelBufferCount, 2, MAX_PIXEL_BUFFERS);
+    const auto previousIndex = pixelBufferIndex;
+    pixelBufferIndex = (pixelBufferIndex + 1) % count;
+
+    auto &fence = pixelBufferFences[pixelBufferIndex];
+    if (fence != nullptr)
+    {
+        // Waits on the GPU, so the CPU can keep queueing work
+        glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
 
+    uintPixels = pixelBuffers[pixelBufferIndex];
+    tileMask = tileMasks[pixelBufferIndex];
     if (particlesProgram != nullptr)
     {
-        particlesProgram->SetIVec2("RenderTextureDimensions", particleSize);
         particlesProgram->SetSSBO("PixelBufferSSBO", uintPixels);
-        particlesProgram->SetFloat("eMax", particleEMax);
+        particlesProgram->SetSSBO("TileMaskSSBO", tileMask);
     }
-
     if (outputProgram != nullptr)
     {
-        outputProgram->SetIVec2("RenderTextureDimensions", particleSize);
-        outputProgram->SetSSBO("PixelBufferSSBO", uintPixels);
-        outputProgram->SetFloat("outputScalar", outputScalar);
+        outputProgram->SetSSBO("PixelBufferSSBO", pixelBuffers[previousIndex]);
+        outputProgram->SetSSBO("TileMaskSSBO", tileMasks[previousIndex]);
+    }
+    if (clearProgram != nullptr)
+    {
+        clearProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        clearProgram->SetSSBO("TileMaskSSBO", tileMask);
+    }
+    if (decayProgram != nullptr)
+    {
+        decayProgram->SetSSBO("PixelBufferSSBO", uintPixels);
+        decayProgram->SetSSBO("TileMaskSSBO", tileMask);
     }
 }
 
-static void recreateParticlesSSBO()
+// Fences the buffer the output pass has just read
+static void fenceDisplayedPixelBuffer()
 {
+    const auto count = std::clamp(pixelBufferCount, 2, MAX_PIXEL_BUFFERS);
+    auto &fence = pixelBufferFences[(pixelBufferIndex + count - 1) % count];
+    if (fence != nullptr)
     {
-        const auto particleCount = getParticleCount();
-        const auto particles = std::vector<glm::vec4>(particleCount, glm::vec4{0.0f, 0.0f, 0.0f, 0.0f});
-        particleBuffer->Update(particles);
+        glDeleteSync(fence);
     }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
 
+static void bindParticlesSSBO()
+{
     if (particlesProgram != nullptr)
     {
         particlesProgram->SetSSBO("ParticleBufferSSBO", particleBuffer);
+        particlesProgram->SetSSBO("RespawnQueueSSBO", respawnQueueBuffer);
+    }
+    if (burnInProgram != nullptr)
+    {
+        burnInProgram->SetSSBO("ParticleBufferSSBO", particleBuffer);
+    }
+    if (respawnProgram != nullptr)
+    {
+        respawnProgram->SetSSBO("ParticleBufferSSBO", particleBuffer);
+        respawnProgram->SetSSBO("RespawnQueueSSBO", respawnQueueBuffer);
     }
 }
 
-static void recreateMVP(int width, int height)
+// Room for every particle while the queue is on, freed otherwise
+static void recreateRespawnQueueSSBO()
 {
-    const auto aspect = static_cast<float>(width) / static_cast<float>(height);
-    projection = glm::perspective(glm::radians(30.0f), aspect, 0.01f, 100.0f);
+    if (respawnQueue)
+    {
+        if (respawnQueueBuffer == nullptr)
+        {
+            respawnQueueBuffer = std::make_shared<SSBO>();
+        }
+        respawnQueueBuffer->Update(nullptr, RESPAWN_QUEUE_HEADER_SIZE + getParticleCount() * sizeof(uint32_t));
+    }
+    else
+    {
+        respawnQueueBuffer.reset();
+    }
+}
 
-    view = glm::lookAt(eyePos, {0.0f, 0.0f, 0.0f}, glm::vec3(0.0f, 1.0f, 0.0f));
+static void bindBudgetSSBO()
+{
+    if (budgetProgram != nullptr)
+    {
+        budgetProgram->SetSSBO("BudgetSSBO", budgetBuffer);
+    }
+}
 
-    if (particlesProgram != nullptr)
+static void releaseBudgetQueries()
+{
+    for (auto &query : budgetQueries)
     {
-        particlesProgram->SetMat4("MVP", projection * view);
+        if (query != 0)
+        {
+            glDeleteQueries(1, &query);
+            query = 0;
+        }
+    }
+    budgetQueryPending = false;
+}
+
+// Restarts the budget from every particle while it is on, and frees it otherwise
+static void recreateBudgetSSBO()
+{
+    budgetQueryPending = false;
+    if (adaptiveBudget)
+    {
+        if (budgetBuffer == nullptr)
+        {
+            budgetBuffer = std::make_shared<SSBO>();
+        }
+        BudgetState state;
+        state.Dispatch[0] = static_cast<uint32_t>(dispatchSize.x);
+        state.Dispatch[1] = static_cast<uint32_t>(dispatchSize.y);
+        state.Dispatch[2] = static_cast<uint32_t>(dispatchSize.z);
+        state.Layers = static_cast<float>(dispatchSize.z);
+        budgetBuffer->Update(&state, sizeof(state));
+    }
+    else
+    {
+        budgetBuffer.reset();
+        releaseBudgetQueries();
+    }
+    bindBudgetSSBO();
+}
+
+static void recreateParticlesSSBO()
+{
+    {
+        const auto particleCount = getParticleCount();
+        const auto particles = std::vector<glm::vec4>(particleCount, glm::vec4{0.0f, 0.0f, 0.0f, 0.0f});
+        particleBuffer->Update(particles);
+    }
+    recreateRespawnQueueSSBO();
+    recreateBudgetSSBO();
+
+    bindParticlesSSBO();
+    rebuildInstanceTable();
+    requestBurnIn();
+}
+
+// Recompiles the shader variants and rebinds the buffers to the new programs
+static void rebuildShaders()
+{
+    reloadShaders();
+    bindPixelsSSBO();
+    bindParticlesSSBO();
+    bindVolumeSSBO();
+    bindBudgetSSBO();
+}
+
+// Passed as the layer count to dispatch the layers chosen by the adaptive budget
+#define BUDGETED_LAYERS (-1)
+
+// Advances and splats layerCount z layers of work groups from firstLayer, every particle by default. With the respawn
+// queue, the particles it queued are then seeded by a dispatch sized on the GPU
+static void dispatchParticles(const int firstLayer = 0, const int layerCount = dispatchSize.z)
+{
+    const auto queued = respawnQueue && respawnProgram != nullptr && respawnQueueBuffer != nullptr;
+    if (queued)
+    {
+        // No groups to dispatch and no entries
+        constexpr uint32_t emptyQueue[4] = {0u, 1u, 1u, 0u};
+        respawnQueueBuffer->UpdateRange(0, emptyQueue, sizeof(emptyQueue));
     }
+
+    particlesProgram->Use();
+    if (timeSlicing)
+    {
+        particlesProgram->SetIVec2("ParticleSlice", glm::ivec2(firstLayer, dispatchSize.z));
+        particlesProgram->SetFloat("SliceWeight", static_cast<float>(dispatchSize.z) / static_cast<float>(layerCount));
+    }
+    if (adaptiveBudget)
+    {
+        particlesProgram->SetInt("ParticleLayers", dispatchSize.z);
+    }
+    if (layerCount == BUDGETED_LAYERS)
+    {
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, budgetBuffer->GLBuffer);
+        glDispatchComputeIndirect(0);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    }
+    else
+    {
+        glDispatchCompute(dispatchSize.x, dispatchSize.y, layerCount);
+    }
+
+    if (queued)
+    {
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        respawnProgram->Use();
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, respawnQueueBuffer->GLBuffer);
+        glDispatchComputeIndirect(0);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    }
+}
+
+// Runs one spawning dispatch over cleared particles and compares the start positions with the CPU mirror
+static void checkRandomParity()
+{
+    if (particlesProgram == nullptr)
+    {
+        randomQualityStatus += "GPU parity: shaders failed to compile\n";
+        return;
+    }
+
+    clearParticlesSSBO();
+    dispatchParticles();
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    const auto sampleCount = std::min<size_t>(RANDOM_PARITY_SAMPLES, getParticleCount());
+    std::vector<glm::vec4> particles(sampleCount);
+    glGetNamedBufferSubData(particleBuffer->GLBuffer, 0, static_cast<GLsizeiptr>(sampleCount * sizeof(glm::vec4)), particles.data());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < sampleCount; i++)
+    {
+        const auto words = RandomWords(randomGenerator, teaRounds, static_cast<uint32_t>(i), static_cast<uint32_t>(uniforms.Frame.Seed), 0u);
+        const auto expected = (RandomUnitVec3(words) - 0.5f) * 2.0f;
+        if (glm::length(expected - glm::vec3(particles[i])) > 1e-6f)
+        {
+            mismatches++;
+        }
+    }
+    randomQualityStatus += "GPU parity: " + std::to_string(mismatches) + " of " + std::to_string(sampleCount) + " particles differ\n";
+
+    requestBurnIn();
+}
+
+// Density image error of freshly seeded particles against particle count, for the selected generator next to PCG
+static void checkSeedingConvergence()
+{
+    const std::vector<uint32_t> particleCounts{1u << 10, 1u << 12, 1u << 14, 1u << 16};
+    const auto &attractors = attractorInstances.front().Parameters;
+
+    randomQualityStatus = "Seeding error at";
+    for (const auto count : particleCounts)
+    {
+        randomQualityStatus += " " + std::to_string(count);
+    }
+    randomQualityStatus += " particles\n";
+
+    for (const auto generator : {RandomGenerator::PCG, randomGenerator})
+    {
+        const auto errors = EvaluateSeedingConvergence(generator, teaRounds, attractors, particleCounts);
+        randomQualityStatus += generator == RandomGenerator::PCG ? "PCG4D:" : "Selected:";
+        for (const auto error : errors)
+        {
+            char value[32];
+            snprintf(value, sizeof(value), " %.4f", error);
+            randomQualityStatus += value;
+        }
+        randomQualityStatus += "\n";
+        if (randomGenerator == RandomGenerator::PCG)
+        {
+            break;
+        }
+    }
+}
+
+static void checkRandomQuality()
+{
+    const auto report = EvaluateRandomQuality(randomGenerator, teaRounds, 1u, 1u << 20);
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "Chi-square: %.1f\nMean: %.4f\nSerial correlation: %.5f\nComponent correlation: %.5f\nMax bit bias: %.5f\nCPU: %.2f ns/sample\n",
+             report.ChiSquare, report.Mean, report.SerialCorrelation, report.ComponentCorrelation, report.MaxBitBias, report.NanosecondsPerSample);
+    randomQualityStatus = buffer;
+
+    checkRandomParity();
+}
+
+// Restarts the particles, pixels and frame sequence so a deterministic render repeats exactly
+static void resetDeterministic()
+{
+    deterministicFrame = 0;
+    updateAttractors();
+    clearPixelSSBO();
+    accumulatedFrames = 0;
+}
+
+static void recreateMVP(int width, int height)
+{
+    const auto aspect = static_cast<float>(width) / static_cast<float>(height);
+    projection = glm::perspective(glm::radians(30.0f), aspect, 0.01f, 100.0f);
+
+    view = glm::lookAt(eyePos, {0.0f, 0.0f, 0.0f}, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    const auto matrices = GetViewMatrices(viewMode, orbitViewCount, projection, aspect, eyePos, stereoSeparation);
+    std::copy(matrices.begin(), matrices.end(), uniforms.Frame.MVP);
+    uniforms.Scene.ViewCount = static_cast<int32_t>(matrices.size());
+    uniforms.Scene.OutputLayer = std::min(outputLayer, uniforms.Scene.ViewCount - 1);
+}
+
+// Reads the current pixel buffer back in row-major order, every layer one after another
+static std::vector<uint64_t> readPixels()
+{
+    std::vector<uint64_t> pixels(uintPixels->Size / sizeof(uint64_t));
+    glGetNamedBufferSubData(uintPixels->GLBuffer, 0, uintPixels->Size, pixels.data());
+    return ToRowMajor(pixelLayout, std::move(pixels), particleSize.x, particleSize.y, uniforms.Scene.ViewCount);
+}
+
+static PixelPackingFormat getPackingFormat(const PixelLayout layout)
+{
+    return layout == PixelLayout::Morton ? PixelPackingFormat::R21G22B21Morton : PixelPackingFormat::R21G22B21;
+}
+
+static void saveCheckpoint()
+{
+    CheckpointHeader header;
+    std::copy_n(glm::value_ptr(attractorInstances.front().Parameters), 4, header.Attractors);
+    std::copy_n(glm::value_ptr(eyePos), 3, header.EyePos);
+    header.EMax = particleEMax;
+    std::copy_n(glm::value_ptr(particleSize), 2, header.Resolution);
+    std::copy_n(glm::value_ptr(dispatchSize), 3, header.DispatchSize);
+    header.PackingFormat = getPackingFormat(pixelLayout);
+    header.AccumulatedFrames = accumulatedFrames;
+    header.InstanceCount = static_cast<uint32_t>(attractorInstances.size());
+    header.InstanceRecordSize = sizeof(AttractorInstanceSettings);
+    header.ViewMode = static_cast<uint32_t>(viewMode);
+    header.ViewCount = static_cast<uint32_t>(uniforms.Scene.ViewCount);
+
+    const auto instanceTableSize = attractorInstances.size() * sizeof(AttractorInstanceSettings);
+    if (!checkpointWriter->Begin(checkpointPath, header, *particleBuffer, *uintPixels, attractorInstances.data(), instanceTableSize))
+    {
+        checkpointStatus = "A checkpoint is already being written";
+    }
+}
+
+static void loadCheckpoint()
+{
+    try
+    {
+        const CheckpointFile checkpoint{checkpointPath};
+        const auto &header = checkpoint.Header();
+        if (header.PackingFormat != PixelPackingFormat::R21G22B21 && header.PackingFormat != PixelPackingFormat::R21G22B21Morton)
+        {
+            throw std::runtime_error("Unsupported checkpoint pixel packing format");
+        }
+        const auto layout = header.PackingFormat == PixelPackingFormat::R21G22B21Morton ? PixelLayout::Morton : PixelLayout::RowMajor;
+
+        // Checked before any setting is applied, so a bad file leaves the current render untouched. Older checkpoints
+        // leave ViewCount zeroed and hold a single layer
+        const auto loadedViewMode = header.ViewCount > 1 ? static_cast<ViewMode>(header.ViewMode) : ViewMode::Single;
+        const auto loadedViewCount = std::max(header.ViewCount, 1u);
+        if (loadedViewMode > ViewMode::CubeMap || static_cast<uint32_t>(GetViewCount(loadedViewMode, static_cast<int>(std::min<uint32_t>(loadedViewCount, MAX_VIEWS)))) != loadedViewCount)
+        {
+            throw std::runtime_error("Unsupported checkpoint views");
+        }
+        const glm::ivec3 loadedDispatch = glm::make_vec3(header.DispatchSize);
+        const glm::ivec2 loadedResolution = glm::make_vec2(header.Resolution);
+        if (loadedDispatch.x <= 0 || loadedDispatch.y <= 0 || loadedDispatch.z <= 0 || loadedResolution.x <= 0 || loadedResolution.y <= 0)
+        {
+            throw std::runtime_error("Invalid checkpoint dispatch size or resolution");
+        }
+        // SSBO sizes are 32-bit
+        constexpr uint64_t maxBufferSize = std::numeric_limits<unsigned int>::max();
+        const auto particleBufferSize = 16ull * 16ull * static_cast<uint64_t>(loadedDispatch.x) * static_cast<uint64_t>(loadedDispatch.y) * static_cast<uint64_t>(loadedDispatch.z) * sizeof(glm::vec4);
+        const auto pixelBufferSize = static_cast<uint64_t>(GetPixelBufferLength(layout, loadedResolution.x, loadedResolution.y, static_cast<int>(loadedViewCount))) * sizeof(uint64_t);
+        if (header.ParticleBufferSize != particleBufferSize || header.PixelBufferSize != pixelBufferSize)
+        {
+            throw std::runtime_error("Checkpoint buffer sizes do not match its dispatch size, resolution and views");
+        }
+        if (particleBufferSize > maxBufferSize || pixelBufferSize > maxBufferSize)
+        {
+            throw std::runtime_error("Checkpoint buffers are larger than 4 GiB");
+        }
+        if (static_cast<uint64_t>(header.InstanceCount) * header.InstanceRecordSize > header.InstanceTableSize)
+        {
+            throw std::runtime_error("Truncated checkpoint instance table");
+        }
+
+        const auto instanceTable = static_cast<const AttractorInstanceSettings *>(checkpoint.InstanceTable());
+        if (instanceTable != nullptr && header.InstanceCount > 0 && header.InstanceRecordSize == sizeof(AttractorInstanceSettings))
+        {
+            attractorInstances.assign(instanceTable, instanceTable + header.InstanceCount);
+        }
+        else
+        {
+            attractorInstances = {AttractorInstanceSettings{}};
+            attractorInstances.front().Parameters = glm::make_vec4(header.Attractors);
+        }
+        eyePos = glm::make_vec3(header.EyePos);
+        animateEyePos = false;
+        particleEMax = header.EMax;
+        particleSize = loadedResolution;
+        dispatchSize = loadedDispatch;
+        viewMode = loadedViewMode;
+        orbitViewCount = viewMode == ViewMode::Orbit ? static_cast<int>(loadedViewCount) : orbitViewCount;
+        // Compiled without reloadShaders, which would clear the particles copied in below
+        if (layout != pixelLayout)
+        {
+            pixelLayout = layout;
+            if (!compileShaders())
+            {
+                throw std::runtime_error("Failed to compile the shaders for the checkpoint pixel layout");
+            }
+        }
+
+        // Resizes every pipelined pixel buffer and the decay history to the loaded resolution, views and layout, and
+        // makes the first buffer current
+        recreatePixelsSSBO();
+        accumulatedFrames = header.AccumulatedFrames;
+
+        // Copy straight from the file mapping into persistently mapped buffers
+        constexpr GLbitfield storageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT;
+        particleBuffer->Storage(nullptr, static_cast<unsigned int>(header.ParticleBufferSize), storageFlags);
+        uintPixels->Storage(nullptr, static_cast<unsigned int>(header.PixelBufferSize), storageFlags);
+        if (particleBuffer->MappedPointer == nullptr || uintPixels->MappedPointer == nullptr)
+        {
+            throw std::runtime_error("Failed to map checkpoint buffers");
+        }
+        memcpy(particleBuffer->MappedPointer, checkpoint.ParticleData(), header.ParticleBufferSize);
+        memcpy(uintPixels->MappedPointer, checkpoint.PixelData(), header.PixelBufferSize);
+
+        recreateMVP(particleSize.x, particleSize.y);
+        rebuildInstanceTable();
+        // Sized for the loaded dispatch
+        recreateRespawnQueueSSBO();
+        recreateBudgetSSBO();
+        // The programs may be new, so bind everything as rebuildShaders does
+        bindParticlesSSBO();
+        bindPixelsSSBO();
+        bindVolumeSSBO();
+        // The tile masks are not saved, so every tile may hold pixels
+        tileMask->Update(std::vector<uint32_t>(getTileMaskWordCount(), ~0u));
+
+        burnInStepsRemaining = 0;
+        accumulatePixels = true;
+        checkpointStatus = "Loaded checkpoint: " + checkpointPath;
+    }
+    catch (const std::exception &e)
+    {
+        checkpointStatus = e.what();
+        std::cerr << e.what() << '\n';
+    }
+}
+
+// Lays out one instance per preset in a grid facing the camera
+static void createPresetAtlas()
+{
+    constexpr float spacing = 5.0f;
+    const auto columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(attractorPresets.size()))));
+    const auto rows = static_cast<int>((attractorPresets.size() + columns - 1) / columns);
+
+    attractorInstances.clear();
+    for (size_t i = 0; i < attractorPresets.size(); i++)
+    {
+        const auto column = static_cast<int>(i) % columns;
+        const auto row = static_cast<int>(i) / columns;
+
+        AttractorInstanceSettings settings;
+        settings.Parameters = attractorPresets[i];
+        settings.Position = glm::vec3((static_cast<float>(column) - static_cast<float>(columns - 1) * 0.5f) * spacing, (static_cast<float>(rows - 1) * 0.5f - static_cast<float>(row)) * spacing, 0.0f);
+        attractorInstances.push_back(settings);
+    }
+
+    animateEyePos = false;
+    eyePos = glm::vec3(0.0f, 0.0f, spacing * static_cast<float>(std::max(columns, rows)) * 2.2f);
+    recreateMVP(particleSize.x, particleSize.y);
+
+    updateAttractors();
+}
+
+static bool hasExtension(const std::string &name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        if (name == reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The aggregated splat needs ballot and arithmetic subgroup operations in compute shaders
+static bool detectSubgroupAggregation()
+{
+    if (!hasExtension("GL_KHR_shader_subgroup"))
+    {
+        return false;
+    }
+
+    GLint stages = 0;
+    GLint features = 0;
+    glGetIntegerv(GL_SUBGROUP_SUPPORTED_STAGES_KHR, &stages);
+    glGetIntegerv(GL_SUBGROUP_SUPPORTED_FEATURES_KHR, &features);
+    constexpr GLint requiredFeatures = GL_SUBGROUP_FEATURE_BASIC_BIT_KHR | GL_SUBGROUP_FEATURE_BALLOT_BIT_KHR | GL_SUBGROUP_FEATURE_ARITHMETIC_BIT_KHR;
+    return (stages & GL_COMPUTE_SHADER_BIT) != 0 && (features & requiredFeatures) == requiredFeatures;
+}
+
+static void appInit()
+{
+    particleSeedDistribution = std::uniform_int_distribution<unsigned short>(0);
+
+    for (int i = 0; i < MAX_PIXEL_BUFFERS; i++)
+    {
+        pixelBuffers.push_back(std::make_shared<SSBO>());
+        tileMasks.push_back(std::make_shared<SSBO>());
+    }
+    pixelBufferFences.resize(MAX_PIXEL_BUFFERS, nullptr);
+    uintPixels = pixelBuffers.front();
+    tileMask = tileMasks.front();
+    particleBuffer = std::make_shared<SSBO>();
+    instanceBuffer = std::make_shared<SSBO>();
+    checkpointWriter = std::make_unique<CheckpointWriter>();
+    uniformRing = std::make_unique<UniformRing>(sizeof(UniformSlot), UNIFORM_RING_SLOTS);
+
+    subgroupAggregationSupported = detectSubgroupAggregation();
+
+    recreateMVP(particleSize.x, particleSize.y);
+    reloadShaders();
+
+    recreatePixelsSSBO();
+    recreateParticlesSSBO();
+}
+
+static void appResize(int width, int height)
+{
+    // The pixel buffer holds a poster tile until the poster is finished
+    if (poster != nullptr)
+    {
+        poster->SavedParticleSize = glm::ivec2(width, height);
+        return;
+    }
+
+    recreateMVP(width, height);
+    particleSize = glm::ivec2(width, height);
+    recreatePixelsSSBO();
+}
+
+// Advances the pending burn-in by up to burnInStepsPerFrame steps
+static void runBurnIn()
+{
+    if (burnInStepsRemaining <= 0)
+    {
+        return;
+    }
+
+    if (burnInProgram == nullptr)
+    {
+        burnInStepsRemaining = 0;
+        return;
+    }
+
+    const auto steps = std::min(burnInStepsRemaining, std::max(burnInStepsPerFrame, 1));
+
+    burnInProgram->Use();
+    burnInProgram->SetInt("BurnInSteps", steps);
+    glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    burnInStepsRemaining -= steps;
+}
+
+// Counting sort of the particles by instance, then by screen cell along a Morton curve. Needs this frame's uniforms
+static void sortParticles()
+{
+    if (sortKeysProgram == nullptr || sortScanProgram == nullptr || sortScatterProgram == nullptr)
+    {
+        return;
+    }
+
+    // Only allocated once sorting is used
+    const auto particleCount = getParticleCount();
+    const auto bucketCount = SORT_BUCKETS_PER_INSTANCE * instanceRows.size();
+    if (sortKeys == nullptr)
+    {
+        sortKeys = std::make_shared<SSBO>();
+        sortBuckets = std::make_shared<SSBO>();
+        sortedParticles = std::make_shared<SSBO>();
+    }
+    if (sortKeys->Size != particleCount * sizeof(uint32_t))
+    {
+        sortKeys->Update(nullptr, particleCount * sizeof(uint32_t));
+        sortedParticles->Update(nullptr, particleCount * sizeof(glm::vec4));
+    }
+    if (sortBuckets->Size != bucketCount * sizeof(uint32_t))
+    {
+        sortBuckets->Update(nullptr, bucketCount * sizeof(uint32_t));
+    }
+
+    for (const auto &program : {sortKeysProgram, sortScanProgram, sortScatterProgram})
+    {
+        program->SetSSBO("ParticleBufferSSBO", particleBuffer);
+        program->SetSSBO("SortKeySSBO", sortKeys);
+        program->SetSSBO("SortBucketSSBO", sortBuckets);
+        program->SetSSBO("SortedParticleSSBO", sortedParticles);
+    }
+
+    sortBuckets->Bind();
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    sortKeysProgram->Use();
+    glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    sortScanProgram->Use();
+    sortScanProgram->SetInt("BucketCount", static_cast<int>(bucketCount));
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    sortScatterProgram->Use();
+    glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    glCopyNamedBufferSubData(sortedParticles->GLBuffer, particleBuffer->GLBuffer, 0, 0, static_cast<GLsizeiptr>(particleCount * sizeof(glm::vec4)));
+}
+
+static void releaseSortBuffers()
+{
+    sortKeys.reset();
+    sortBuckets.reset();
+    sortedParticles.reset();
+}
+
+// Copies this frame's uniform blocks into the next ring slot and binds both blocks
+static void uploadUniforms()
+{
+    memcpy(uniformRing->Acquire(), &uniforms, sizeof(UniformSlot));
+    uniformRing->BindRanges(FRAME_BLOCK_BINDING, {offsetof(UniformSlot, Frame), offsetof(UniformSlot, Scene)}, {sizeof(FrameUniforms), sizeof(SceneUniforms)});
+}
+
+// Ray-marches the volume into every view of the current pixel buffer. Needs this frame's uniforms
+static void resolveVolume()
+{
+    if (volumeProgram == nullptr || volumeBuffer == nullptr)
+    {
+        return;
+    }
+
+    if (dirtyTiles)
+    {
+        // Every pixel is rewritten, so only the marks need clearing
+        tileMask->Bind();
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+
+    volumeProgram->Use();
+    for (int view = 0; view < uniforms.Scene.ViewCount; view++)
+    {
+        volumeProgram->SetMat4("InverseMVP[" + std::to_string(view) + "]", glm::inverse(uniforms.Frame.MVP[view]));
+    }
+    // Averaged over the frames, so the image keeps the brightness of one projected frame as the volume fills
+    volumeProgram->SetFloat("VolumeBrightness", volumeGain / static_cast<float>(std::max<uint64_t>(volumeFrames, 1)));
+    glDispatchCompute((particleSize.x + 15) / 16, (particleSize.y + 15) / 16, uniforms.Scene.ViewCount);
+}
+
+static bool isDecaying()
+{
+    return temporalDecay && !accumulatePixels && !densityVolume && decayProgram != nullptr && decayHistory != nullptr;
+}
+
+// Fades the history, adds this frame's splats to it and writes it back over the pixel buffer. Needs this frame's uniforms
+static void resolveDecay()
+{
+    decayWeight = decayWeight * decayFactor + 1.0;
+
+    decayProgram->Use();
+    decayProgram->SetFloat("DecayFactor", decayFactor);
+    decayProgram->SetFloat("DecayScale", static_cast<float>(1.0 / decayWeight));
+    glDispatchCompute((particleSize.x + 15) / 16, (particleSize.y + 15) / 16, uniforms.Scene.ViewCount);
+}
+
+static bool isSorting()
+{
+    // The scatter fills each bucket in atomic order and particles respawn by index, so a sorted deterministic frame
+    // would not reproduce. Poster tiles would each sort by their own camera
+    return sortInterval > 0 && !deterministic && poster == nullptr;
+}
+
+static bool isTimeSliced()
+{
+    // Deterministic frames must splat every particle to match renders made in other processes
+    return timeSlicing && !adaptiveBudget && !deterministic && !densityVolume;
+}
+
+static bool isBudgeted()
+{
+    return adaptiveBudget && budgetProgram != nullptr && budgetBuffer != nullptr && !deterministic && !densityVolume;
+}
+
+// Copies last budgeted frame's GPU time into the budget buffer and sizes this frame's splat from it, then starts timing
+// this frame. Nothing here waits for the GPU
+static void beginBudgetedFrame()
+{
+    if (budgetQueryPending)
+    {
+        glGetQueryBufferObjectui64v(budgetQueries[budgetQueryIndex ^ 1], budgetBuffer->GLBuffer, GL_QUERY_RESULT, offsetof(BudgetState, Elapsed));
+
+        budgetProgram->Use();
+        budgetProgram->SetFloat("TargetMilliseconds", budgetTarget);
+        budgetProgram->SetInt("ParticleLayers", dispatchSize.z);
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    }
+
+    auto &query = budgetQueries[budgetQueryIndex];
+    if (query == 0)
+    {
+        glGenQueries(1, &query);
+    }
+    glBeginQuery(GL_TIME_ELAPSED, query);
+}
+
+static void endBudgetedFrame()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    budgetQueryIndex ^= 1;
+    budgetQueryPending = true;
+}
+
+// Splats the next slice of layers, sized from the GPU time of earlier slices
+static void dispatchParticleSlice()
+{
+    auto &query = sliceQueries[sliceQueryIndex];
+    if (query == 0)
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        // Issued SLICE_QUERY_COUNT frames ago, so normally finished
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != 0)
+        {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            const auto layerMilliseconds = static_cast<double>(nanoseconds) * 1e-6 / std::max(sliceQueryLayers[sliceQueryIndex], 1);
+            sliceLayerMilliseconds = sliceLayerMilliseconds > 0.0 ? glm::mix(sliceLayerMilliseconds, layerMilliseconds, 0.25) : layerMilliseconds;
+        }
+    }
+
+    if (sliceLayerMilliseconds > 0.0)
+    {
+        sliceLayers = static_cast<int>(static_cast<double>(sliceBudget) / sliceLayerMilliseconds);
+    }
+    sliceLayers = std::clamp(sliceLayers, 1, dispatchSize.z);
+
+    // The last slice of a rotation stops at the end of the grid rather than wrapping, and is weighted up to match
+    sliceFirstLayer = sliceFirstLayer < dispatchSize.z ? sliceFirstLayer : 0;
+    const auto layerCount = std::min(sliceLayers, dispatchSize.z - sliceFirstLayer);
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    dispatchParticles(sliceFirstLayer, layerCount);
+    glEndQuery(GL_TIME_ELAPSED);
+
+    sliceQueryLayers[sliceQueryIndex] = layerCount;
+    sliceQueryIndex = (sliceQueryIndex + 1) % SLICE_QUERY_COUNT;
+    sliceFirstLayer += layerCount;
+}
+
+static void releaseSliceQueries()
+{
+    for (auto &query : sliceQueries)
+    {
+        if (query != 0)
+        {
+            glDeleteQueries(1, &query);
+            query = 0;
+        }
+    }
+    sliceLayerMilliseconds = 0.0;
+}
+
+// Advances the simulation by one frame, splatting into the pixel buffer once any burn-in has finished.
+// Acquires a uniform ring slot, which the caller must release. Returns the frame time
+static uint32_t getDeterministicSeed(const uint32_t frame)
+{
+    return RandomPCG4D(glm::uvec4(frame, DETERMINISTIC_SEED, 0u, 0u)).x & 0xFFFFu;
+}
+
+static float simulateFrame()
+{
+    float frameTime;
+    if (deterministic)
+    {
+        particleSeed = static_cast<int>(getDeterministicSeed(deterministicFrame));
+        frameTime = static_cast<float>(deterministicFrame) * DETERMINISTIC_FRAME_TIME;
+        deterministicFrame++;
+    }
+    else
+    {
+        particleSeed = particleSeedDistribution(randomEngine);
+        frameTime = static_cast<float>(glfwGetTime());
+    }
+
+    uniforms.Frame.Time = frameTime;
+    uniforms.Frame.Seed = particleSeed;
+    uploadUniforms();
+
+    const auto pipelined = isPipelined() && burnInStepsRemaining <= 0;
+    if (pipelined)
+    {
+        advancePixelBuffer();
+    }
+
+    runBurnIn();
+
+    // Keep presenting the previous image until the burn-in has finished, rather than splatting the transient
+    if (burnInStepsRemaining <= 0)
+    {
+        // Times the frame's passes after the burn-in, whose cost does not depend on the budget
+        const auto budgeted = isBudgeted();
+        if (budgeted)
+        {
+            beginBudgetedFrame();
+        }
+
+        const auto simulate = !densityVolume || !volumeFrozen;
+        if (densityVolume)
+        {
+            // The volume always accumulates, the pixels being resolved from it below
+            volumeFrames += simulate ? 1 : 0;
+        }
+        else if (accumulatePixels)
+        {
+            accumulatedFrames++;
+        }
+        else
+        {
+            clearPixelSSBO();
+            accumulatedFrames = 1;
+        }
+
+        if (simulate && isSorting() && ++framesSinceSort >= sortInterval)
+        {
+            framesSinceSort = 0;
+            sortParticles();
+        }
+
+        if (simulate && particlesProgram != nullptr)
+        {
+            if (budgeted)
+            {
+                dispatchParticles(0, BUDGETED_LAYERS);
+            }
+            else if (isTimeSliced())
+            {
+                dispatchParticleSlice();
+            }
+            else
+            {
+                dispatchParticles();
+            }
+        }
+
+        if (densityVolume)
+        {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            resolveVolume();
+        }
+        else if (isDecaying())
+        {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            resolveDecay();
+        }
+
+        if (budgeted)
+        {
+            endBudgetedFrame();
+        }
+    }
+
+    // A pipelined frame's splats are only resolved next frame, after advancePixelBuffer's barrier
+    if (!pipelined)
+    {
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    return frameTime;
+}
+
+// GPU time of SORT_BENCHMARK_FRAMES splat dispatches, in milliseconds
+static double timeSplatDispatches()
+{
+    GLuint query;
+    glGenQueries(1, &query);
+
+    double totalMilliseconds = 0.0;
+    for (int frame = 0; frame < SORT_BENCHMARK_FRAMES; frame++)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        dispatchParticles();
+        glEndQuery(GL_TIME_ELAPSED);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        totalMilliseconds += static_cast<double>(nanoseconds) / 1e6;
+    }
+
+    glDeleteQueries(1, &query);
+    return totalMilliseconds;
+}
+
+// Times the splat dispatch in the current particle order, sorts, then times it again. The extra splats are cleared
+static void benchmarkSort()
+{
+    if (particlesProgram == nullptr || sortKeysProgram == nullptr)
+    {
+        sortBenchmarkStatus = "Shaders are not loaded";
+        return;
+    }
+
+    uploadUniforms();
+    const auto before = timeSplatDispatches() / SORT_BENCHMARK_FRAMES;
+
+    GLuint query;
+    glGenQueries(1, &query);
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    sortParticles();
+    glEndQuery(GL_TIME_ELAPSED);
+    GLuint64 sortNanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &sortNanoseconds);
+    glDeleteQueries(1, &query);
+
+    const auto after = timeSplatDispatches() / SORT_BENCHMARK_FRAMES;
+    uniformRing->Release();
+
+    clearPixelSSBO();
+    accumulatedFrames = 0;
+    if (sortInterval <= 0)
+    {
+        releaseSortBuffers();
+    }
+
+    const auto splats = static_cast<double>(getParticleCount()) * uniforms.Scene.ViewCount;
+    char status[256];
+    snprintf(status, sizeof(status), "Splat: %.2f ms (%.2f G/s) -> %.2f ms (%.2f G/s) sorted, sort: %.2f ms", before, splats / (before * 1e6), after, splats / (after * 1e6), static_cast<double>(sortNanoseconds) / 1e6);
+    sortBenchmarkStatus = status;
+}
+
+// Times the splat dispatch on each preset under every trig mode, next to the CPU mirror's density error against the
+// native functions. The instances are restored afterwards
+static void benchmarkTrig()
+{
+    constexpr TrigMode modes[] = {TrigMode::Native, TrigMode::Shared, TrigMode::Polynomial};
+    constexpr const char *modeNames[] = {"Native", "Shared", "Polynomial"};
+    const auto savedMode = trigMode;
+    const auto savedInstances = attractorInstances;
+
+    uploadUniforms();
+    std::vector<double> milliseconds(attractorPresets.size() * std::size(modes), 0.0);
+    for (size_t mode = 0; mode < std::size(modes); mode++)
+    {
+        trigMode = modes[mode];
+        rebuildShaders();
+        if (particlesProgram == nullptr || burnInProgram == nullptr)
+        {
+            break;
+        }
+
+        for (size_t preset = 0; preset < attractorPresets.size(); preset++)
+        {
+            attractorInstances = {AttractorInstanceSettings{}};
+            attractorInstances.front().Parameters = attractorPresets[preset];
+            updateAttractors();
+            // Time splats of particles on the attractor, not of the respawn
+            while (burnInStepsRemaining > 0)
+            {
+                runBurnIn();
+            }
+            milliseconds[preset * std::size(modes) + mode] = timeSplatDispatches() / SORT_BENCHMARK_FRAMES;
+        }
+    }
+    uniformRing->Release();
+
+    trigMode = savedMode;
+    attractorInstances = savedInstances;
+    rebuildShaders();
+    clearPixelSSBO();
+    accumulatedFrames = 0;
+
+    std::string report;
+    for (size_t preset = 0; preset < attractorPresets.size(); preset++)
+    {
+        report += "Preset " + std::to_string(preset + 1) + "\n";
+        const auto nativeMilliseconds = milliseconds[preset * std::size(modes)];
+        for (size_t mode = 0; mode < std::size(modes); mode++)
+        {
+            const auto time = milliseconds[preset * std::size(modes) + mode];
+            const auto accuracy = EvaluateTrigAccuracy(modes[mode], attractorPresets[preset], TRIG_BENCHMARK_PARTICLES, TRIG_BENCHMARK_STEPS);
+            char line[160];
+            snprintf(line, sizeof(line), "  %-10s %.3f ms (%.2fx)  error %.4f, noise %.4f\n", modeNames[mode], time, time > 0.0 ? nativeMilliseconds / time : 0.0, accuracy.DensityError, accuracy.NoiseFloor);
+            report += line;
+        }
+    }
+    trigBenchmarkStatus = report;
+}
+
+static void startPoster()
+{
+    try
+    {
+        auto render = std::make_unique<PosterRender>();
+        render->Writer = std::make_unique<TiledTiffWriter>(posterPath, posterSize.x, posterSize.y, posterTileSize);
+
+        const auto aspect = static_cast<float>(posterSize.x) / static_cast<float>(posterSize.y);
+        render->ViewProjection = glm::perspective(glm::radians(30.0f), aspect, 0.01f, 100.0f) * glm::lookAt(eyePos, {0.0f, 0.0f, 0.0f}, glm::vec3(0.0f, 1.0f, 0.0f));
+        render->FramesPerTile = std::max(posterFramesPerTile, 1);
+        // Keep the on-screen brightness, as each pixel now receives fewer particles per frame but more frames
+        render->EMax = static_cast<float>(static_cast<double>(particleEMax) * render->FramesPerTile * particleSize.x * particleSize.y / (static_cast<double>(posterSize.x) * posterSize.y));
+
+        render->SavedParticleSize = particleSize;
+        render->SavedViewMode = viewMode;
+        render->SavedAccumulatePixels = accumulatePixels;
+        render->SavedDeterministic = deterministic;
+        render->SavedAnimateEyePos = animateEyePos;
+        render->SavedBurnInStepsPerFrame = burnInStepsPerFrame;
+        poster = std::move(render);
+    }
+    catch (const std::exception &e)
+    {
+        posterStatus = e.what();
+        std::cerr << e.what() << '\n';
+        return;
+    }
+
+    particleSize = glm::ivec2(posterTileSize);
+    viewMode = ViewMode::Single;
+    accumulatePixels = true;
+    deterministic = true;
+    animateEyePos = false;
+    burnInStepsPerFrame = burnInSteps;
+    recreateMVP(particleSize.x, particleSize.y);
+    recreatePixelsSSBO();
+    uniforms.Scene.EMax = poster->EMax;
+    posterStatus = "Rendering poster: " + posterPath;
+}
+
+static void finishPoster()
+{
+    const auto error = poster->Writer->Finish();
+    posterStatus = error.empty() ? "Saved poster: " + posterPath : error;
+
+    particleSize = poster->SavedParticleSize;
+    viewMode = poster->SavedViewMode;
+    accumulatePixels = poster->SavedAccumulatePixels;
+    deterministic = poster->SavedDeterministic;
+    animateEyePos = poster->SavedAnimateEyePos;
+    burnInStepsPerFrame = poster->SavedBurnInStepsPerFrame;
+    poster.reset();
+
+    recreateMVP(particleSize.x, particleSize.y);
+    recreatePixelsSSBO();
+    resetDeterministic();
+}
+
+// Renders the next poster tile from scratch through its sub-frustum, then queues it for the writer thread
+static void runPosterTile()
+{
+    auto &writer = *poster->Writer;
+    const auto tileX = poster->NextTile % writer.TilesX;
+    const auto tileY = poster->NextTile / writer.TilesX;
+
+    resetDeterministic();
+    uniforms.Frame.MVP[0] = GetTileProjection(tileX, tileY, writer.TileSize, writer.Width, writer.Height) * poster->ViewProjection;
+    for (int frame = 0; frame < poster->FramesPerTile; frame++)
+    {
+        if (frame > 0)
+        {
+            uniformRing->Release();
+        }
+        simulateFrame();
+    }
+
+    const auto pixels = readPixels();
+    writer.WriteTile(tileX, tileY, ResolvePixels(pixels.data(), writer.TileSize, writer.TileSize, coldColor, hotColor, outputScalar));
+
+    poster->NextTile++;
+    if (poster->NextTile >= writer.TilesX * writer.TilesY)
+    {
+        finishPoster();
+    }
+}
+
+static void appRender()
+{
+    GLState::BeginFrame();
+
+    auto frameTime = uniforms.Frame.Time;
+    if (poster != nullptr)
+    {
+        runPosterTile();
+    }
+    else
+    {
+        frameTime = simulateFrame();
+    }
+
+    if (outputProgram != nullptr)
+    {
+        outputProgram->Use();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    if (isPipelined())
+    {
+        fenceDisplayedPixelBuffer();
+    }
+
+    uniformRing->Release();
+    checkpointWriter->Poll();
+    if (!checkpointWriter->Status.empty())
+    {
+        checkpointStatus = checkpointWriter->Status;
+        checkpointWriter->Status.clear();
+    }
+
+    if (animateEyePos)
+    {
+        constexpr float distance = 10.0f;
+        eyePos = glm::vec3(glm::sin(frameTime * 0.35f), glm::cos(frameTime * 0.25f), glm::sin(frameTime * 0.2f));
+        if (animatedEyePosNormalize)
+        {
+            eyePos = glm::normalize(eyePos);
+        }
+        eyePos *= distance;
+        recreateMVP(particleSize.x, particleSize.y);
+    }
+}
+
+static void appCleanup()
+{
+    checkpointWriter.reset();
+    uniformRing.reset();
+    outputProgram.reset();
+    burnInProgram.reset();
+    particlesProgram.reset();
+    for (auto &fence : pixelBufferFences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    clearProgram.reset();
+    sortKeysProgram.reset();
+    sortScanProgram.reset();
+    sortScatterProgram.reset();
+    releaseSortBuffers();
+    volumeProgram.reset();
+    volumeBuffer.reset();
+    respawnProgram.reset();
+    respawnQueueBuffer.reset();
+    releaseSliceQueries();
+    budgetProgram.reset();
+    budgetBuffer.reset();
+    releaseBudgetQueries();
+    decayProgram.reset();
+    decayHistory.reset();
+    pixelBuffers.clear();
+    tileMasks.clear();
+    uintPixels.reset();
+    tileMask.reset();
+}
+
+static void processInput(GLFWwindow *window);
+static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
+static void APIENTRY debugMessageCallback(GLenum source, GLenum type, unsigned int id, GLenum severity, GLsizei length, const char *message, const void *userParam);
+
+static GLFWwindow *createWindow(const int width, const int height, const bool visible)
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible);
+#if __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+#ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
+#endif
+
+    GLFWwindow *window = glfwCreateWindow(width, height, "SomeParticles", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        glfwTerminate();
+        throw std::runtime_error("Failed to create GLFW window");
+    }
+
+    glfwMakeContextCurrent(window);
+#ifndef VSYNC
+    glfwSwapInterval(0);
+#endif
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        throw std::runtime_error("Failed to initialize GLAD");
+    }
+
+    // Enable debug
+    int flags;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+    {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(&debugMessageCallback, nullptr);
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    }
+
+    return window;
+}
+
+// The interactive app renders on its own thread, which owns the GL context and every global above. The main thread
+// polls events and builds the UI from a copy of the settings, sending each edit back as a command that the render
+// thread runs at the start of its next frame
+
+// The main thread builds a UI frame on every input event, and at least this often
+#define UI_FRAME_INTERVAL (1.0 / 120.0)
+
+// Settings the UI edits, published by the render thread after every frame
+struct UISettings
+{
+    float ParticleEMax = 0.0f;
+    float OutputScalar = 0.0f;
+    bool AccumulatePixels = false;
+    bool TemporalDecay = false;
+    float DecayFactor = 0.0f;
+    bool Deterministic = false;
+    bool PipelinePixels = false;
+    int PixelBufferCount = 2;
+    bool DirtyTiles = false;
+    bool MortonPixels = false;
+    bool DensityVolume = false;
+    int VolumeResolution = 0;
+    float VolumeExtent = 0.0f;
+    float VolumeGain = 0.0f;
+    bool VolumeFrozen = false;
+    int SortInterval = 0;
+    bool SubgroupAggregation = false;
+    bool RespawnQueue = false;
+    bool TimeSlicing = false;
+    float SliceBudget = 0.0f;
+    bool AdaptiveBudget = false;
+    float BudgetTarget = 0.0f;
+    glm::vec3 EyePos{0.0f};
+    bool AnimateEyePos = false;
+    bool AnimatedEyePosNormalize = false;
+    ViewMode CurrentViewMode = ViewMode::Single;
+    int OrbitViewCount = 1;
+    float StereoSeparation = 0.0f;
+    int OutputLayer = -1;
+    glm::ivec3 DispatchSize{1};
+    std::vector<AttractorInstanceSettings> AttractorInstances;
+    int BurnInSteps = 0;
+    int BurnInStepsPerFrame = 0;
+    bool WarmContinuation = false;
+    int ContinuationBurnInSteps = 0;
+    RandomGenerator Generator = RandomGenerator::TEA;
+    TrigMode Trig = TrigMode::Native;
+    int TeaRounds = 0;
+    glm::vec3 ColdColor{0.0f};
+    glm::vec3 HotColor{0.0f};
+    std::string CheckpointPath;
+    std::string PosterPath;
+    glm::ivec2 PosterSize{0};
+    int PosterTileSize = 0;
+    int PosterFramesPerTile = 0;
+};
+
+// Render thread state the UI only displays
+struct RenderStatus
+{
+    uint64_t AccumulatedFrames = 0;
+    uint64_t VolumeFrames = 0;
+    int ViewCount = 1;
+    // Negative when no burn-in or poster is running
+    float BurnInProgress = -1.0f;
+    float PosterProgress = -1.0f;
+    bool CheckpointBusy = false;
+    bool SubgroupAggregationSupported = false;
+    std::string CheckpointStatus;
+    std::string PosterStatus;
+    std::string RandomQualityStatus;
+    std::string SortBenchmarkStatus;
+    std::string TrigBenchmarkStatus;
+    // Z layers splatted per frame and the smoothed GPU time of each, zero until measured
+    int SliceLayers = 0;
+    float SliceLayerMilliseconds = 0.0f;
+    float FrameTime = 0.0f;
+    GLState::Counters Binds;
+    // Smoothed time from an input event to the swap of the first frame that includes it, in seconds
+    float InputLatency = 0.0f;
+};
+
+// ImGui draw lists cloned on the main thread, drawn by the render thread on every frame until a newer one arrives.
+// Created and destroyed on the main thread, which owns the ImGui allocations
+struct UIFrame
+{
+    ImDrawData DrawData;
+    // glfwGetTime() of the earliest input event this frame responds to, or zero
+    double InputTime = 0.0;
+    bool Presented = false;
+
+    ~UIFrame()
+    {
+        for (const auto drawList : DrawData.CmdLists)
+        {
+            IM_DELETE(drawList);
+        }
+    }
+};
+
+static std::mutex renderMutex;
+static std::vector<std::function<void()>> pendingCommands;
+static std::unique_ptr<UIFrame> pendingUIFrame;
+static std::vector<std::unique_ptr<UIFrame>> retiredUIFrames;
+static UISettings publishedSettings;
+static RenderStatus publishedStatus;
+static uint64_t publishedCommandCount = 0;
+static std::atomic<bool> stopRendering{false};
+static std::exception_ptr renderError;
+
+// Render thread only
+static std::vector<std::function<void()>> runningCommands;
+static uint64_t appliedCommandCount = 0;
+static float inputLatency = 0.0f;
+
+// Main thread only
+static UISettings uiSettings;
+static RenderStatus renderStatus;
+static uint64_t postedCommandCount = 0;
+static double pendingInputTime = 0.0;
+static int selectedInstance = 0;
+static bool showUI = true;
+
+static void postRenderCommand(std::function<void()> command)
+{
+    std::lock_guard lock(renderMutex);
+    pendingCommands.push_back(std::move(command));
+    postedCommandCount++;
+}
+
+// Copies the UI's edited instance into the render thread's table, unless that table has been replaced since
+static void postInstanceEdit(const int index, const bool parametersChanged)
+{
+    postRenderCommand([index, settings = uiSettings.AttractorInstances[index], parametersChanged]
+    {
+        if (index < static_cast<int>(attractorInstances.size()))
+        {
+            attractorInstances[index] = settings;
+            updateInstance(index, parametersChanged);
+        }
+    });
+}
+
+static void postInstanceTable()
+{
+    postRenderCommand([instances = uiSettings.AttractorInstances]
+    {
+        attractorInstances = instances;
+        updateAttractors();
+    });
+}
+
+// Takes the queued commands together with the newest UI frame, so a UI edit is never shown before its effect
+static void applyRenderCommands(std::unique_ptr<UIFrame> &uiFrame)
+{
+    {
+        std::lock_guard lock(renderMutex);
+        runningCommands.swap(pendingCommands);
+        if (pendingUIFrame != nullptr)
+        {
+            if (uiFrame != nullptr)
+            {
+                retiredUIFrames.push_back(std::move(uiFrame));
+            }
+            uiFrame = std::move(pendingUIFrame);
+        }
+    }
+
+    for (const auto &command : runningCommands)
+    {
+        command();
+    }
+    appliedCommandCount += runningCommands.size();
+    runningCommands.clear();
+}
+
+static void publishRenderState()
+{
+    UISettings settings;
+    settings.ParticleEMax = particleEMax;
+    settings.OutputScalar = outputScalar;
+    settings.AccumulatePixels = accumulatePixels;
+    settings.TemporalDecay = temporalDecay;
+    settings.DecayFactor = decayFactor;
+    settings.Deterministic = deterministic;
+    settings.PipelinePixels = pipelinePixels;
+    settings.PixelBufferCount = pixelBufferCount;
+    settings.DirtyTiles = dirtyTiles;
+    settings.MortonPixels = pixelLayout == PixelLayout::Morton;
+    settings.DensityVolume = densityVolume;
+    settings.VolumeResolution = volumeResolution;
+    settings.VolumeExtent = volumeExtent;
+    settings.VolumeGain = volumeGain;
+    settings.VolumeFrozen = volumeFrozen;
+    settings.SortInterval = sortInterval;
+    settings.SubgroupAggregation = subgroupAggregation;
+    settings.RespawnQueue = respawnQueue;
+    settings.TimeSlicing = timeSlicing;
+    settings.SliceBudget = sliceBudget;
+    settings.AdaptiveBudget = adaptiveBudget;
+    settings.BudgetTarget = budgetTarget;
+    settings.EyePos = eyePos;
+    settings.AnimateEyePos = animateEyePos;
+    settings.AnimatedEyePosNormalize = animatedEyePosNormalize;
+    settings.CurrentViewMode = viewMode;
+    settings.OrbitViewCount = orbitViewCount;
+    settings.StereoSeparation = stereoSeparation;
+    settings.OutputLayer = outputLayer;
+    settings.DispatchSize = dispatchSize;
+    settings.AttractorInstances = attractorInstances;
+    settings.BurnInSteps = burnInSteps;
+    settings.BurnInStepsPerFrame = burnInStepsPerFrame;
+    settings.WarmContinuation = warmContinuation;
+    settings.ContinuationBurnInSteps = continuationBurnInSteps;
+    settings.Generator = randomGenerator;
+    settings.Trig = trigMode;
+    settings.TeaRounds = teaRounds;
+    settings.ColdColor = coldColor;
+    settings.HotColor = hotColor;
+    settings.CheckpointPath = checkpointPath;
+    settings.PosterPath = posterPath;
+    settings.PosterSize = posterSize;
+    settings.PosterTileSize = posterTileSize;
+    settings.PosterFramesPerTile = posterFramesPerTile;
+
+    RenderStatus status;
+    status.AccumulatedFrames = accumulatedFrames;
+    status.VolumeFrames = volumeFrames;
+    status.ViewCount = uniforms.Scene.ViewCount;
+    status.SliceLayers = sliceLayers;
+    status.SliceLayerMilliseconds = static_cast<float>(sliceLayerMilliseconds);
+    if (burnInStepsRemaining > 0 && burnInStepsTotal > 0)
+    {
+        status.BurnInProgress = 1.0f - static_cast<float>(burnInStepsRemaining) / static_cast<float>(burnInStepsTotal);
+    }
+    if (poster != nullptr)
+    {
+        status.PosterProgress = static_cast<float>(poster->NextTile) / static_cast<float>(poster->Writer->TilesX * poster->Writer->TilesY);
+    }
+    status.CheckpointBusy = checkpointWriter->Busy();
+    status.SubgroupAggregationSupported = subgroupAggregationSupported;
+    status.CheckpointStatus = checkpointStatus;
+    status.PosterStatus = posterStatus;
+    status.RandomQualityStatus = randomQualityStatus;
+    status.SortBenchmarkStatus = sortBenchmarkStatus;
+    status.TrigBenchmarkStatus = trigBenchmarkStatus;
+    status.FrameTime = deltaTime;
+    status.Binds = GLState::LastFrame;
+    status.InputLatency = inputLatency;
+
+    std::lock_guard lock(renderMutex);
+    publishedSettings = std::move(settings);
+    publishedStatus = std::move(status);
+    publishedCommandCount = appliedCommandCount;
+}
+
+// Refreshes the UI's copy of the settings, unless some of its edits are still queued and would be reverted
+static void syncUIState()
+{
+    std::vector<std::unique_ptr<UIFrame>> retired;
+    {
+        std::lock_guard lock(renderMutex);
+        renderStatus = publishedStatus;
+        if (publishedCommandCount == postedCommandCount)
+        {
+            uiSettings = publishedSettings;
+        }
+        retired.swap(retiredUIFrames);
+    }
+}
+
+// Hands a deep copy of this frame's ImGui draw data to the render thread, replacing any frame it has not picked up yet
+static void publishUIFrame(const ImDrawData &drawData)
+{
+    auto frame = std::make_unique<UIFrame>();
+    frame->DrawData.Valid = true;
+    frame->DrawData.DisplayPos = drawData.DisplayPos;
+    frame->DrawData.DisplaySize = drawData.DisplaySize;
+    frame->DrawData.FramebufferScale = drawData.FramebufferScale;
+    frame->DrawData.TotalIdxCount = drawData.TotalIdxCount;
+    frame->DrawData.TotalVtxCount = drawData.TotalVtxCount;
+    for (const auto drawList : drawData.CmdLists)
+    {
+        frame->DrawData.CmdLists.push_back(drawList->CloneOutput());
+    }
+    frame->DrawData.CmdListsCount = frame->DrawData.CmdLists.Size;
+    frame->InputTime = pendingInputTime;
+    pendingInputTime = 0.0;
+
+    std::unique_ptr<UIFrame> replaced;
+    {
+        std::lock_guard lock(renderMutex);
+        replaced = std::move(pendingUIFrame);
+        if (replaced != nullptr && replaced->InputTime > 0.0)
+        {
+            frame->InputTime = frame->InputTime > 0.0 ? std::min(frame->InputTime, replaced->InputTime) : replaced->InputTime;
+        }
+        pendingUIFrame = std::move(frame);
+    }
+}
+
+static void drawSettingsWindow()
+{
+    auto &ui = uiSettings;
+
+    ImGui::SetNextWindowSize(ImVec2(360, 640), ImGuiCond_Once);
+    if (ImGui::Begin("Settings"))
+    {
+#ifndef EMBEDDED_SHADERS
+        if (ImGui::Button("Reload Shaders"))
+        {
+            postRenderCommand([]
+            {
+                // The new programs need every buffer bound again, not just the pixels
+                rebuildShaders();
+                recreatePixelsSSBO();
+            });
+        }
+#endif
+
+        if (ImGui::InputFloat("Particle eMax", &ui.ParticleEMax, 0, 0, "%.0f"))
+        {
+            postRenderCommand([value = ui.ParticleEMax]
+            {
+                particleEMax = value;
+                uniforms.Scene.EMax = value;
+            });
+        }
+
+        if (ImGui::DragFloat("Output Scalar", &ui.OutputScalar, 0.01f, 0, 0, "%.2f"))
+        {
+            postRenderCommand([value = ui.OutputScalar]
+            {
+                outputScalar = value;
+                uniforms.Scene.OutputScalar = value;
+            });
+        }
+
+        if (ImGui::Checkbox("Accumulate", &ui.AccumulatePixels))
+        {
+            postRenderCommand([value = ui.AccumulatePixels]
+            {
+                accumulatePixels = value;
+                // The output pass may be reading a pipelined buffer
+                bindPixelsSSBO();
+                clearPixelSSBO();
+                accumulatedFrames = 0;
+            });
+        }
+        ImGui::SameLine();
+        if (ImGui::Checkbox("Deterministic", &ui.Deterministic))
+        {
+            postRenderCommand([value = ui.Deterministic]
+            {
+                deterministic = value;
+                resetDeterministic();
+            });
+        }
+        if (ui.AccumulatePixels)
+        {
+            ImGui::SameLine();
+            ImGui::Text("Frames: %llu", static_cast<unsigned long long>(renderStatus.AccumulatedFrames));
+        }
+
+        ImGui::BeginDisabled(ui.AccumulatePixels);
+        if (ImGui::Checkbox("Decay", &ui.TemporalDecay))
+        {
+            postRenderCommand([value = ui.TemporalDecay]
+            {
+                temporalDecay = value;
+                recreateDecaySSBO();
+                bindPixelsSSBO();
+            });
+        }
+        if (ui.TemporalDecay)
+        {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120.0f);
+            if (ImGui::SliderFloat("Decay Factor", &ui.DecayFactor, 0.0f, 0.99f, "%.2f"))
+            {
+                postRenderCommand([value = ui.DecayFactor]
+                {
+                    decayFactor = value;
+                });
+            }
+            ImGui::SameLine();
+            ImGui::Text("~%.0f frames", 1.0f / (1.0f - ui.DecayFactor));
+        }
+        bool pipelineChanged = ImGui::Checkbox("Pipelined", &ui.PipelinePixels);
+        if (ui.PipelinePixels)
+        {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120.0f);
+            pipelineChanged |= ImGui::SliderInt("Pixel Buffers", &ui.PixelBufferCount, 2, MAX_PIXEL_BUFFERS);
+        }
+        ImGui::EndDisabled();
+        if (pipelineChanged)
+        {
+            postRenderCommand([value = ui.PipelinePixels, count = ui.PixelBufferCount]
+            {
+                pipelinePixels = value;
+                pixelBufferCount = count;
+                recreatePixelsSSBO();
+            });
+        }
+        if (ImGui::Checkbox("Dirty Tiles", &ui.DirtyTiles))
+        {
+            postRenderCommand([value = ui.DirtyTiles]
+            {
+                dirtyTiles = value;
+                rebuildShaders();
+                // Start with empty masks that match the pixels
+                recreatePixelsSSBO();
+            });
+        }
+        if (ImGui::Checkbox("Morton Pixels", &ui.MortonPixels))
+        {
+            postRenderCommand([value = ui.MortonPixels]
+            {
+                pixelLayout = value ? PixelLayout::Morton : PixelLayout::RowMajor;
+                rebuildShaders();
+                // The accumulated pixels are in the old order
+                recreatePixelsSSBO();
+            });
+        }
+
+        if (ImGui::Checkbox("Density Volume", &ui.DensityVolume))
+        {
+            postRenderCommand([value = ui.DensityVolume]
+            {
+                densityVolume = value;
+                rebuildShaders();
+                recreateVolumeSSBO();
+                recreatePixelsSSBO();
+                accumulatedFrames = 0;
+            });
+        }
+        if (ui.DensityVolume)
+        {
+            ImGui::SameLine();
+            if (ImGui::Checkbox("Freeze", &ui.VolumeFrozen))
+            {
+                postRenderCommand([value = ui.VolumeFrozen]
+                {
+                    volumeFrozen = value;
+                });
+            }
+            ImGui::SameLine();
+            ImGui::Text("Frames: %llu", static_cast<unsigned long long>(renderStatus.VolumeFrames));
+
+            // Reallocated only once the slider is let go, a 512^3 volume being half a gigabyte
+            ImGui::SliderInt("Volume Resolution", &ui.VolumeResolution, 32, MAX_VOLUME_RESOLUTION);
+            const auto resolutionChanged = ImGui::IsItemDeactivatedAfterEdit();
+            ImGui::DragFloat("Volume Extent", &ui.VolumeExtent, 0.01f, 0.1f, 100.0f);
+            if (resolutionChanged || ImGui::IsItemDeactivatedAfterEdit())
+            {
+                postRenderCommand([resolution = ui.VolumeResolution, extent = ui.VolumeExtent]
+                {
+                    volumeResolution = std::clamp(resolution, 1, MAX_VOLUME_RESOLUTION);
+                    volumeExtent = std::max(extent, 0.1f);
+                    recreateVolumeSSBO();
+                });
+            }
+            if (ImGui::DragFloat("Volume Gain", &ui.VolumeGain, 0.01f, 0.0f, 1000.0f))
+            {
+                postRenderCommand([value = ui.VolumeGain]
+                {
+                    volumeGain = value;
+                });
+            }
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        if (ImGui::DragFloat3("View Pos", glm::value_ptr(ui.EyePos), 0.05f))
+        {
+            postRenderCommand([value = ui.EyePos]
+            {
+                eyePos = value;
+                recreateMVP(particleSize.x, particleSize.y);
+            });
+        }
+        bool animationChanged = ImGui::Checkbox("Animate View Pos", &ui.AnimateEyePos);
+        ImGui::SameLine();
+        animationChanged |= ImGui::Checkbox("Normalized Distance", &ui.AnimatedEyePosNormalize);
+        if (animationChanged)
+        {
+            postRenderCommand([animate = ui.AnimateEyePos, normalize = ui.AnimatedEyePosNormalize]
+            {
+                animateEyePos = animate;
+                animatedEyePosNormalize = normalize;
+            });
+        }
+
+        auto viewModeIndex = static_cast<int>(ui.CurrentViewMode);
+        bool viewsChanged = ImGui::Combo("Views", &viewModeIndex, "Single\0Stereo\0Orbit\0Cube Map\0");
+        ui.CurrentViewMode = static_cast<ViewMode>(viewModeIndex);
+        if (ui.CurrentViewMode == ViewMode::Orbit)
+        {
+            viewsChanged |= ImGui::SliderInt("Orbit Views", &ui.OrbitViewCount, 1, MAX_VIEWS);
+        }
+        if (viewsChanged)
+        {
+            postRenderCommand([mode = ui.CurrentViewMode, count = ui.OrbitViewCount]
+            {
+                viewMode = mode;
+                orbitViewCount = count;
+                recreateMVP(particleSize.x, particleSize.y);
+                recreatePixelsSSBO();
+            });
+        }
+        if (ui.CurrentViewMode == ViewMode::Stereo && ImGui::DragFloat("Eye Separation", &ui.StereoSeparation, 0.01f))
+        {
+            postRenderCommand([value = ui.StereoSeparation]
+            {
+                stereoSeparation = value;
+                recreateMVP(particleSize.x, particleSize.y);
+            });
+        }
+        if (renderStatus.ViewCount > 1 && ImGui::SliderInt("Output Layer", &ui.OutputLayer, -1, renderStatus.ViewCount - 1, ui.OutputLayer < 0 ? "Grid" : "%d"))
+        {
+            postRenderCommand([value = ui.OutputLayer]
+            {
+                outputLayer = value;
+                uniforms.Scene.OutputLayer = std::min(value, uniforms.Scene.ViewCount - 1);
+            });
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        if (ImGui::InputInt3("Dispatch Size", glm::value_ptr(ui.DispatchSize)))
+        {
+            postRenderCommand([value = ui.DispatchSize]
+            {
+                dispatchSize = value;
+                recreateParticlesSSBO();
+            });
+        }
+
+        std::stringstream ss;
+        ss.imbue(std::locale(""));
+        ss << getParticleCount(ui.DispatchSize);
+        ImGui::Text("Particles: %s", ss.str().c_str());
+
+        if (ImGui::InputInt("Sort Every", &ui.SortInterval))
+        {
+            ui.SortInterval = std::max(ui.SortInterval, 0);
+            postRenderCommand([value = ui.SortInterval]
+            {
+                sortInterval = value;
+                framesSinceSort = 0;
+                if (sortInterval <= 0)
+                {
+                    releaseSortBuffers();
+                }
+            });
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark"))
+        {
+            postRenderCommand(benchmarkSort);
+        }
+        if (!renderStatus.SortBenchmarkStatus.empty())
+        {
+            ImGui::TextWrapped("%s", renderStatus.SortBenchmarkStatus.c_str());
+        }
+
+        ImGui::BeginDisabled(!renderStatus.SubgroupAggregationSupported);
+        if (ImGui::Checkbox(renderStatus.SubgroupAggregationSupported ? "Subgroup Atomics" : "Subgroup Atomics (unsupported)", &ui.SubgroupAggregation))
+        {
+            postRenderCommand([value = ui.SubgroupAggregation]
+            {
+                subgroupAggregation = value;
+                rebuildShaders();
+            });
+        }
+        ImGui::EndDisabled();
+        if (ImGui::Checkbox("Respawn Queue", &ui.RespawnQueue))
+        {
+            postRenderCommand([value = ui.RespawnQueue]
+            {
+                respawnQueue = value;
+                recreateRespawnQueueSSBO();
+                rebuildShaders();
+            });
+        }
+        ImGui::BeginDisabled(ui.AdaptiveBudget);
+        if (ImGui::Checkbox("Time Slicing", &ui.TimeSlicing))
+        {
+            postRenderCommand([value = ui.TimeSlicing]
+            {
+                timeSlicing = value;
+                sliceFirstLayer = 0;
+                rebuildShaders();
+            });
+        }
+        if (ui.TimeSlicing)
+        {
+            if (ImGui::DragFloat("Slice Budget", &ui.SliceBudget, 0.1f, 0.5f, 100.0f, "%.1f ms"))
+            {
+                postRenderCommand([value = ui.SliceBudget]
+                {
+                    sliceBudget = value;
+                });
+            }
+            const auto layers = std::max(renderStatus.SliceLayers, 1);
+            ImGui::Text("%d of %d layers per frame, every particle each %d frames", layers, ui.DispatchSize.z, (ui.DispatchSize.z + layers - 1) / layers);
+            if (renderStatus.SliceLayerMilliseconds > 0.0f)
+            {
+                ImGui::Text("%.3f ms per layer", renderStatus.SliceLayerMilliseconds);
+            }
+        }
+        ImGui::EndDisabled();
+        if (ImGui::Checkbox("Adaptive Budget", &ui.AdaptiveBudget))
+        {
+            postRenderCommand([value = ui.AdaptiveBudget]
+            {
+                adaptiveBudget = value;
+                recreateBudgetSSBO();
+                rebuildShaders();
+            });
+        }
+        if (ui.AdaptiveBudget && ImGui::DragFloat("Target GPU Time", &ui.BudgetTarget, 0.1f, 0.5f, 100.0f, "%.1f ms"))
+        {
+            postRenderCommand([value = ui.BudgetTarget]
+            {
+                budgetTarget = value;
+            });
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        selectedInstance = std::clamp(selectedInstance, 0, static_cast<int>(ui.AttractorInstances.size()) - 1);
+        const std::string selectedLabel = "Instance " + std::to_string(selectedInstance + 1);
+        if (ImGui::BeginCombo("##Attractor Instances", selectedLabel.c_str()))
+        {
+            for (size_t i = 0; i < ui.AttractorInstances.size(); i++)
+            {
+                std::string label = "Instance " + std::to_string(i + 1);
+                if (ImGui::Selectable(label.c_str(), static_cast<int>(i) == selectedInstance))
+                {
+                    selectedInstance = static_cast<int>(i);
+                }
+            }
+
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Add"))
+        {
+            ui.AttractorInstances.push_back(ui.AttractorInstances[selectedInstance]);
+            selectedInstance = static_cast<int>(ui.AttractorInstances.size()) - 1;
+            postInstanceTable();
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(ui.AttractorInstances.size() <= 1);
+        if (ImGui::Button("Remove"))
+        {
+            ui.AttractorInstances.erase(ui.AttractorInstances.begin() + selectedInstance);
+            selectedInstance = std::min(selectedInstance, static_cast<int>(ui.AttractorInstances.size()) - 1);
+            postInstanceTable();
+        }
+        ImGui::EndDisabled();
+
+        auto &instance = ui.AttractorInstances[selectedInstance];
+        if (ImGui::InputFloat4("Attractors", glm::value_ptr(instance.Parameters)))
+        {
+            postInstanceEdit(selectedInstance, true);
+        }
+
+        if (ImGui::BeginCombo("##Attractor Presets", "Attractor Presets"))
+        {
+            for (size_t i = 0; i < attractorPresets.size(); i++)
+            {
+                std::string label = "Preset " + std::to_string(i + 1);
+                if (ImGui::Selectable(label.c_str(), false))
+                {
+                    instance.Parameters = attractorPresets[i];
+                    postInstanceEdit(selectedInstance, true);
+                }
+            }
+
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Preset Atlas"))
+        {
+            selectedInstance = 0;
+            postRenderCommand(createPresetAtlas);
+        }
+
+        bool instanceChanged = ImGui::DragFloat3("Position", glm::value_ptr(instance.Position), 0.05f);
+        instanceChanged |= ImGui::DragFloat3("Rotation", glm::value_ptr(instance.Rotation), 1.0f);
+        instanceChanged |= ImGui::DragFloat("Scale", &instance.Scale, 0.01f);
+        instanceChanged |= ImGui::ColorEdit3("Color", glm::value_ptr(instance.Color));
+        if (instanceChanged)
+        {
+            postInstanceEdit(selectedInstance, false);
+        }
+        if (ImGui::DragFloat("Weight", &instance.Weight, 0.01f, 0.0f, 100.0f))
+        {
+            postInstanceTable();
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        bool burnInChanged = ImGui::InputInt("Burn-in Steps", &ui.BurnInSteps);
+        burnInChanged |= ImGui::InputInt("Burn-in Steps/Frame", &ui.BurnInStepsPerFrame);
+        if (burnInChanged)
+        {
+            postRenderCommand([steps = ui.BurnInSteps, stepsPerFrame = ui.BurnInStepsPerFrame]
+            {
+                burnInSteps = steps;
+                burnInStepsPerFrame = stepsPerFrame;
+            });
+        }
+        if (ImGui::Button("Burn In"))
+        {
+            postRenderCommand(requestBurnIn);
+        }
+        if (renderStatus.BurnInProgress >= 0.0f)
+        {
+            ImGui::SameLine();
+            ImGui::ProgressBar(renderStatus.BurnInProgress);
+        }
+        bool continuationChanged = ImGui::Checkbox("Warm Continuation", &ui.WarmContinuation);
+        if (ui.WarmContinuation)
+        {
+            continuationChanged |= ImGui::InputInt("Continuation Steps", &ui.ContinuationBurnInSteps);
+            ui.ContinuationBurnInSteps = std::max(ui.ContinuationBurnInSteps, 0);
+        }
+        if (continuationChanged)
+        {
+            postRenderCommand([value = ui.WarmContinuation, steps = ui.ContinuationBurnInSteps]
+            {
+                warmContinuation = value;
+                continuationBurnInSteps = steps;
+            });
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        auto generatorIndex = static_cast<int>(ui.Generator);
+        bool generatorChanged = ImGui::Combo("RNG", &generatorIndex, "TEA + LCG\0PCG4D\0Philox4x32\0R3 (quasi-random)\0");
+        ui.Generator = static_cast<RandomGenerator>(generatorIndex);
+        if (ui.Generator == RandomGenerator::TEA && ImGui::InputInt("TEA Rounds", &ui.TeaRounds))
+        {
+            ui.TeaRounds = std::clamp(ui.TeaRounds, 1, 32);
+            generatorChanged = true;
+        }
+        if (generatorChanged)
+        {
+            postRenderCommand([generator = ui.Generator, rounds = ui.TeaRounds]
+            {
+                randomGenerator = generator;
+                teaRounds = rounds;
+                rebuildShaders();
+            });
+        }
+        if (ImGui::Button("Check RNG"))
+        {
+            postRenderCommand(checkRandomQuality);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Seeding Convergence"))
+        {
+            postRenderCommand(checkSeedingConvergence);
+        }
+        if (!renderStatus.RandomQualityStatus.empty())
+        {
+            ImGui::TextUnformatted(renderStatus.RandomQualityStatus.c_str());
+        }
+
+        auto trigIndex = static_cast<int>(ui.Trig);
+        if (ImGui::Combo("Trig", &trigIndex, "Native\0Shared\0Polynomial\0"))
+        {
+            ui.Trig = static_cast<TrigMode>(trigIndex);
+            postRenderCommand([mode = ui.Trig]
+            {
+                trigMode = mode;
+                rebuildShaders();
+            });
+        }
+        if (ImGui::Button("Trig Benchmark"))
+        {
+            postRenderCommand(benchmarkTrig);
+        }
+        if (!renderStatus.TrigBenchmarkStatus.empty())
+        {
+            ImGui::TextUnformatted(renderStatus.TrigBenchmarkStatus.c_str());
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        bool colorsChanged = ImGui::ColorEdit3("Cold Color", glm::value_ptr(ui.ColdColor));
+        colorsChanged |= ImGui::ColorEdit3("Hot Color", glm::value_ptr(ui.HotColor));
+        if (colorsChanged)
+        {
+            postRenderCommand([cold = ui.ColdColor, hot = ui.HotColor]
+            {
+                coldColor = cold;
+                hotColor = hot;
+                updateColors();
+            });
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        if (ImGui::InputText("Checkpoint", &ui.CheckpointPath))
+        {
+            postRenderCommand([path = ui.CheckpointPath]
+            {
+                checkpointPath = path;
+            });
+        }
+        ImGui::BeginDisabled(renderStatus.CheckpointBusy);
+        if (ImGui::Button("Save Checkpoint"))
+        {
+            postRenderCommand(saveCheckpoint);
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        if (ImGui::Button("Load Checkpoint"))
+        {
+            selectedInstance = 0;
+            postRenderCommand(loadCheckpoint);
+        }
+        if (!renderStatus.CheckpointStatus.empty())
+        {
+            ImGui::TextWrapped("%s", renderStatus.CheckpointStatus.c_str());
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        bool posterChanged = ImGui::InputText("Poster", &ui.PosterPath);
+        posterChanged |= ImGui::InputInt2("Poster Size", glm::value_ptr(ui.PosterSize));
+        posterChanged |= ImGui::InputInt("Tile Size", &ui.PosterTileSize, 16);
+        posterChanged |= ImGui::InputInt("Frames/Tile", &ui.PosterFramesPerTile);
+        if (posterChanged)
+        {
+            postRenderCommand([path = ui.PosterPath, size = ui.PosterSize, tileSize = ui.PosterTileSize, framesPerTile = ui.PosterFramesPerTile]
+            {
+                posterPath = path;
+                posterSize = size;
+                posterTileSize = tileSize;
+                posterFramesPerTile = framesPerTile;
+            });
+        }
+        ImGui::BeginDisabled(renderStatus.PosterProgress >= 0.0f);
+        if (ImGui::Button("Render Poster"))
+        {
+            postRenderCommand([]
+            {
+                if (poster == nullptr)
+                {
+                    startPoster();
+                }
+            });
+        }
+        ImGui::EndDisabled();
+        if (renderStatus.PosterProgress >= 0.0f)
+        {
+            ImGui::SameLine();
+            ImGui::ProgressBar(renderStatus.PosterProgress);
+        }
+        if (!renderStatus.PosterStatus.empty())
+        {
+            ImGui::TextWrapped("%s", renderStatus.PosterStatus.c_str());
+        }
+
+        ImGui::Spacing();
+        ImGui::Spacing();
+
+        ImGui::Text("FPS: %.1f", 1.0f / renderStatus.FrameTime);
+        ImGui::Text("Input latency: %.1f ms", renderStatus.InputLatency * 1000.0f);
+        ImGui::Text("GL binds: %u issued, %u elided", renderStatus.Binds.Issued, renderStatus.Binds.Elided);
+
+        ImGui::End();
+    }
+}
+
+// Owns the GL context while the window is open: applies the UI's commands, renders, draws the newest UI frame,
+// presents, then publishes its state for the next UI frame
+static void renderLoop(GLFWwindow *window, std::promise<void> &ready)
+{
+    glfwMakeContextCurrent(window);
+    try
+    {
+        ImGui_ImplOpenGL3_Init();
+        // Builds the font atlas, which the main thread needs before its first ImGui::NewFrame
+        ImGui_ImplOpenGL3_NewFrame();
+        appInit();
+        publishRenderState();
+    }
+    catch (...)
+    {
+        glfwMakeContextCurrent(nullptr);
+        ready.set_exception(std::current_exception());
+        return;
+    }
+    ready.set_value();
+
+    std::unique_ptr<UIFrame> uiFrame;
+    try
+    {
+        auto lastTime = std::chrono::high_resolution_clock::now();
+        while (!stopRendering)
+        {
+            auto currentTime = std::chrono::high_resolution_clock::now();
+            deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(currentTime - lastTime).count();
+            lastTime = currentTime;
+
+            applyRenderCommands(uiFrame);
+
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            appRender();
+
+            if (uiFrame != nullptr)
+            {
+                ImGui_ImplOpenGL3_RenderDrawData(&uiFrame->DrawData);
+            }
+
+            glfwSwapBuffers(window);
+
+            if (uiFrame != nullptr && !uiFrame->Presented)
+            {
+                uiFrame->Presented = true;
+                if (uiFrame->InputTime > 0.0)
+                {
+                    const auto latency = static_cast<float>(glfwGetTime() - uiFrame->InputTime);
+                    inputLatency = inputLatency > 0.0f ? glm::mix(inputLatency, latency, 0.1f) : latency;
+                }
+            }
+
+            publishRenderState();
+        }
+    }
+    catch (...)
+    {
+        renderError = std::current_exception();
+        glfwSetWindowShouldClose(window, true);
+        glfwPostEmptyEvent();
+        // The main thread may still be building a UI frame, so only shut down once it has stopped
+        stopRendering.wait(false);
+    }
+
+    appCleanup();
+    ImGui_ImplOpenGL3_Shutdown();
+    glfwMakeContextCurrent(nullptr);
+
+    std::lock_guard lock(renderMutex);
+    if (uiFrame != nullptr)
+    {
+        retiredUIFrames.push_back(std::move(uiFrame));
+    }
+}
+
+static void markInput()
+{
+    if (pendingInputTime <= 0.0)
+    {
+        pendingInputTime = glfwGetTime();
+    }
+}
+
+static void app()
+{
+    GLFWwindow *window = createWindow(INITIAL_WIDTH, INITIAL_HEIGHT, true);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+    // Installed before ImGui's, which chain to these
+    glfwSetKeyCallback(window, [](GLFWwindow *, int, int, int, int) { markInput(); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow *, int, int, int) { markInput(); });
+    glfwSetCursorPosCallback(window, [](GLFWwindow *, double, double) { markInput(); });
+    glfwSetScrollCallback(window, [](GLFWwindow *, double, double) { markInput(); });
+    // Made current again on the render thread
+    glfwMakeContextCurrent(nullptr);
+
+    // Setup Dear ImGui context
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad; // Enable Gamepad Controls
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; // IF using Docking Branch
+
+    ImGui_ImplGlfw_InitForOpenGL(window, true); // Second param install_callback=true will install GLFW callbacks and chain to existing ones.
+
+    std::promise<void> ready;
+    auto readyFuture = ready.get_future();
+    std::thread renderThread(renderLoop, window, std::ref(ready));
+    try
+    {
+        readyFuture.get();
+    }
+    catch (...)
+    {
+        renderThread.join();
+        throw;
+    }
+
+    while (!glfwWindowShouldClose(window))
+    {
+        glfwWaitEventsTimeout(UI_FRAME_INTERVAL);
+        processInput(window);
+        syncUIState();
+
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        if (showUI)
+        {
+            drawSettingsWindow();
+        }
+
+        ImGui::Render();
+        publishUIFrame(*ImGui::GetDrawData());
+    }
+
+    stopRendering = true;
+    stopRendering.notify_one();
+    renderThread.join();
+    pendingUIFrame.reset();
+    retiredUIFrames.clear();
+
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    glfwTerminate();
+
+    if (renderError != nullptr)
+    {
+        std::rethrow_exception(renderError);
+    }
+}
+
+// Sets up a reference scene: each preset on its own, then the preset atlas. Returns the scene name
+static std::string applyRegressionConfig(const size_t index)
+{
+    if (index < attractorPresets.size())
+    {
+        attractorInstances = {AttractorInstanceSettings{}};
+        attractorInstances.front().Parameters = attractorPresets[index];
+        eyePos = glm::vec3{1.5f, 5.0f, 5.0f};
+        recreateMVP(particleSize.x, particleSize.y);
+        return "preset" + std::to_string(index + 1);
+    }
+
+    createPresetAtlas();
+    return "atlas";
+}
+
+// The current regression scene as the CPU mirror of the splat renders it
+static GoldenScene getGoldenScene()
+{
+    GoldenScene scene;
+    scene.Instances = instanceRows;
+    scene.MVP = uniforms.Frame.MVP[0];
+    scene.Resolution = particleSize;
+    scene.EMax = uniforms.Scene.EMax;
+    scene.Generator = randomGenerator;
+    scene.TeaRounds = teaRounds;
+    scene.Trig = trigMode;
+    scene.ParticleCount = static_cast<uint32_t>(getParticleCount());
+    scene.BurnInSteps = burnInSteps;
+    for (uint32_t frame = 0; frame < REGRESSION_FRAMES; frame++)
+    {
+        scene.FrameSeeds.push_back(getDeterministicSeed(frame));
+    }
+    return scene;
+}
+
+// Renders every reference scene deterministically in a hidden window and compares the block sums of the accumulated
+// pixel buffers against the goldens in goldenDirectory. With update set, rewrites the goldens instead, rendered on the
+// GPU or, for GoldenUpdate::Cpu, by the CPU mirror of the splat. Returns the number of failed scenes
+static int regression(const std::string &goldenDirectory, const GoldenUpdate update)
+{
+    particleSize = glm::ivec2(REGRESSION_WIDTH, REGRESSION_HEIGHT);
+    dispatchSize = REGRESSION_DISPATCH;
+    GLFWwindow *window = createWindow(particleSize.x, particleSize.y, false);
+
+    appInit();
+    deterministic = true;
+    accumulatePixels = true;
+    animateEyePos = false;
+    burnInStepsPerFrame = burnInSteps;
+    particleEMax = REGRESSION_EMAX * REGRESSION_FRAMES;
+    bindPixelsSSBO();
+
+    if (update != GoldenUpdate::None)
+    {
+        std::filesystem::create_directories(goldenDirectory);
+    }
+
+    int failures = 0;
+    printf("%-10s %10s %10s %10s  %s\n", "Scene", "ms/frame", "Flux", "Block L1", "Result");
+    for (size_t i = 0; i <= attractorPresets.size(); i++)
+    {
+        const auto name = applyRegressionConfig(i);
+        resetDeterministic();
+        const auto goldenPath = (std::filesystem::path(goldenDirectory) / (name + ".golden")).string();
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        std::vector<uint64_t> pixels;
+        if (update == GoldenUpdate::Cpu)
+        {
+            pixels = RenderGoldenScene(getGoldenScene(), std::thread::hardware_concurrency());
+        }
+        else
+        {
+            glFinish();
+            for (int frame = 0; frame < REGRESSION_FRAMES; frame++)
+            {
+                appRender();
+            }
+            glFinish();
+        }
+        const auto frameMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count() / REGRESSION_FRAMES;
+        if (update != GoldenUpdate::Cpu)
+        {
+            pixels = readPixels();
+        }
+
+        try
+        {
+            const auto blocks = SumGoldenBlocks(pixels.data(), particleSize.x, particleSize.y);
+            if (update != GoldenUpdate::None)
+            {
+                WriteGoldenBlocks(goldenPath, blocks);
+                printf("%-10s %10.2f %10s %10s  Saved %s\n", name.c_str(), frameMilliseconds, "-", "-", goldenPath.c_str());
+                continue;
+            }
+
+            const auto comparison = CompareGoldenBlocks(ReadGoldenBlocks(goldenPath), blocks);
+            printf("%-10s %10.2f %10.4f %10.4f  %s\n", name.c_str(), frameMilliseconds, comparison.FluxRatio, comparison.BlockDistance, comparison.Passed ? "pass" : "FAIL");
+            failures += comparison.Passed ? 0 : 1;
+        }
+        catch (const std::exception &e)
+        {
+            printf("%-10s %10.2f %10s %10s  FAIL: %s\n", name.c_str(), frameMilliseconds, "-", "-", e.what());
+            failures++;
+        }
+    }
+
+    appCleanup();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return failures;
 }
 
-static void appInit()
+// Renders a poster of the default scene in a hidden window. Returns false on failure
+static bool posterHeadless(const std::string &path, const glm::ivec2 &size)
 {
-    particleSeedDistribution = std::uniform_int_distribution<unsigned short>(0);
-
-    uintPixels = std::make_shared<SSBO>();
-    particleBuffer = std::make_shared<SSBO>();
+    GLFWwindow *window = createWindow(INITIAL_WIDTH, INITIAL_HEIGHT, false);
 
-    recreateMVP(INITIAL_WIDTH, INITIAL_HEIGHT);
-    reloadShaders();
+    appInit();
+    posterPath = path;
+    posterSize = size;
+    startPoster();
+    while (poster != nullptr)
+    {
+        const auto tileCount = poster->Writer->TilesX * poster->Writer->TilesY;
+        std::cout << "\rTile " << poster->NextTile + 1 << " / " << tileCount << std::flush;
+        appRender();
+    }
+    std::cout << '\n' << posterStatus << '\n';
+    const auto saved = posterStatus.rfind("Saved", 0) == 0;
 
-    recreatePixelsSSBO();
-    recreateParticlesSSBO();
+    appCleanup();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return saved;
 }
 
-static void appResize(int width, int height)
+// Renders the frames of one job from a coordinator in a hidden window and sends back the accumulated pixel buffer
+static void worker(const std::string &host, const uint16_t port)
 {
-    recreateMVP(width, height);
-    particleSize = glm::ivec2(width, height);
-    recreatePixelsSSBO();
-}
+    const auto connection = Socket::Connect(host, port);
 
-static void appRender()
-{
-    clearPixelSSBO();
+    RenderJob job;
+    connection.ReceiveAll(&job, sizeof(job));
+    if (job.Magic != RENDER_JOB_MAGIC || job.InstanceCount == 0)
+    {
+        throw std::runtime_error("Invalid render job from " + host);
+    }
+    attractorInstances.resize(job.InstanceCount);
+    connection.ReceiveAll(attractorInstances.data(), attractorInstances.size() * sizeof(AttractorInstanceSettings));
 
-    particleSeed = particleSeedDistribution(randomEngine);
+    particleSize = glm::make_vec2(job.Resolution);
+    dispatchSize = glm::make_vec3(job.DispatchSize);
+    particleEMax = job.EMax;
+    eyePos = glm::make_vec3(job.EyePos);
+    std::cout << "Worker " << job.WorkerIndex + 1 << " / " << job.WorkerCount << ": frames " << job.FirstFrame << " to " << job.FirstFrame + job.FrameCount << '\n';
 
-    const auto glfwTime = static_cast<float>(glfwGetTime());
+    GLFWwindow *window = createWindow(particleSize.x, particleSize.y, false);
+    appInit();
+    deterministic = true;
+    accumulatePixels = true;
+    burnInStepsPerFrame = burnInSteps;
 
-    if (particlesProgram != nullptr)
+    resetDeterministic();
+    deterministicFrame = job.FirstFrame;
+    for (uint32_t frame = 0; frame < job.FrameCount; frame++)
     {
-        particlesProgram->Use();
-        particlesProgram->SetFloat("Time", glfwTime);
-        particlesProgram->SetInt("Seed", particleSeed);
-        glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+        appRender();
     }
 
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    RenderResult result;
+    result.WorkerIndex = job.WorkerIndex;
+    const auto pixels = readPixels();
+    result.PixelBufferSize = pixels.size() * sizeof(uint64_t);
 
-    if (outputProgram != nullptr)
+    appCleanup();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    connection.SendAll(&result, sizeof(result));
+    connection.SendAll(pixels.data(), result.PixelBufferSize);
+}
+
+// Splits frameCount deterministic frames of the default scene between workerCount workers, sums their pixel buffers
+// and writes the resolved image. Needs no GL context
+static void coordinator(const uint16_t port, const uint32_t workerCount, const uint32_t frameCount, const std::string &outputPath)
+{
+    const auto listener = Socket::Listen(port);
+    std::cout << "Waiting for " << workerCount << " workers on port " << port << '\n';
+
+    std::vector<Socket> connections;
+    for (uint32_t i = 0; i < workerCount; i++)
     {
-        outputProgram->Use();
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        connections.push_back(listener.Accept());
+        std::cout << "Worker " << i + 1 << " connected\n";
     }
 
-    if (animateEyePos)
+    const auto framesPerWorker = (frameCount + workerCount - 1) / workerCount;
+    // Workers scale eMax by their own frames, so a splat must still add at least one to the red and blue channels
+    const auto workerEMax = particleEMax * static_cast<float>(framesPerWorker);
+    if (workerEMax > static_cast<float>((1 << 21) - 1))
     {
-        constexpr float distance = 10.0f;
-        eyePos = glm::vec3(glm::sin(glfwTime * 0.35f), glm::cos(glfwTime * 0.25f), glm::sin(glfwTime * 0.2f));
-        if (animatedEyePosNormalize)
-        {
-            eyePos = glm::normalize(eyePos);
-        }
-        eyePos *= distance;
-        recreateMVP(particleSize.x, particleSize.y);
+        throw std::runtime_error("Too many frames per worker for eMax " + std::to_string(particleEMax) + ", add workers or render fewer frames");
     }
-
-    if (!showUI)
+    for (uint32_t i = 0; i < workerCount; i++)
     {
-        return;
+        RenderJob job;
+        job.WorkerIndex = i;
+        job.WorkerCount = workerCount;
+        job.FirstFrame = std::min(i * framesPerWorker, frameCount);
+        job.FrameCount = std::min(framesPerWorker, frameCount - job.FirstFrame);
+        std::copy_n(glm::value_ptr(particleSize), 2, job.Resolution);
+        std::copy_n(glm::value_ptr(dispatchSize), 3, job.DispatchSize);
+        // Each buffer has the brightness of a single frame, so no worker overflows its packed channels
+        job.EMax = workerEMax;
+        std::copy_n(glm::value_ptr(eyePos), 3, job.EyePos);
+        job.InstanceCount = static_cast<uint32_t>(attractorInstances.size());
+
+        connections[i].SendAll(&job, sizeof(job));
+        connections[i].SendAll(attractorInstances.data(), attractorInstances.size() * sizeof(AttractorInstanceSettings));
     }
 
-    ImGui::SetNextWindowSize(ImVec2(340, 340), ImGuiCond_Once);
-    if (ImGui::Begin("Settings"))
+    const auto pixelCount = static_cast<size_t>(particleSize.x) * particleSize.y;
+    std::vector<std::vector<uint64_t>> buffers(workerCount);
+    std::vector<std::future<void>> receives;
+    for (uint32_t i = 0; i < workerCount; i++)
     {
-#ifndef EMBEDDED_SHADERS
-        if (ImGui::Button("Reload Shaders"))
-        {
-            reloadShaders();
-            recreatePixelsSSBO();
-        }
-#endif
-
-        if (ImGui::InputFloat("Particle eMax", &particleEMax, 0, 0, "%.0f"))
+        receives.push_back(std::async(std::launch::async, [&connection = connections[i], &buffer = buffers[i], pixelCount]
         {
-            if (particlesProgram != nullptr)
+            RenderResult result;
+            connection.ReceiveAll(&result, sizeof(result));
+            if (result.Magic != RENDER_RESULT_MAGIC || result.PixelBufferSize != pixelCount * sizeof(uint64_t))
             {
-                particlesProgram->SetFloat("eMax", particleEMax);
+                throw std::runtime_error("Invalid render result from worker " + std::to_string(result.WorkerIndex + 1));
             }
-        }
+            buffer.resize(pixelCount);
+            connection.ReceiveAll(buffer.data(), result.PixelBufferSize);
+        }));
+    }
+    for (auto &receive : receives)
+    {
+        receive.get();
+    }
 
-        if (ImGui::DragFloat("Output Scalar", &outputScalar, 0.01f, 0, 0, "%.2f"))
-        {
-            if (outputProgram != nullptr)
-            {
-                outputProgram->SetFloat("outputScalar", outputScalar);
-            }
-        }
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<const uint64_t *> sources;
+    for (const auto &buffer : buffers)
+    {
+        sources.push_back(buffer.data());
+    }
+    std::vector<uint64_t> pixels(pixelCount);
+    // Takes the sum of the workers' buffers back to the brightness of a single frame
+    ReducePixelBuffers(pixels.data(), sources, pixelCount, static_cast<double>(framesPerWorker) / frameCount, std::thread::hardware_concurrency());
+    const auto reduceMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Reduced " << workerCount << " buffers in " << reduceMilliseconds << " ms\n";
+
+    const auto error = WriteTiff(outputPath, particleSize.x, particleSize.y, ResolvePixels(pixels.data(), particleSize.x, particleSize.y, coldColor, hotColor, outputScalar));
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+    std::cout << "Saved " << outputPath << '\n';
+}
 
-        ImGui::Spacing();
-        ImGui::Spacing();
+// A request line received by the daemon, parsed on the connection's thread and run on the GL thread
+struct DaemonJob
+{
+    std::shared_ptr<Socket> Client;
+    std::chrono::high_resolution_clock::time_point ReceivedTime;
+    JsonValue Request;
+    std::string Error;
+};
 
-        if (ImGui::DragFloat3("View Pos", glm::value_ptr(eyePos), 0.05f))
+static std::deque<DaemonJob> daemonQueue;
+static std::mutex daemonMutex;
+static std::condition_variable daemonCondition;
+
+static void readDaemonClient(const std::shared_ptr<Socket> &client)
+{
+    std::string line;
+    while (client->ReceiveLine(line))
+    {
+        if (line.empty())
         {
-            recreateMVP(particleSize.x, particleSize.y);
+            continue;
         }
-        if (ImGui::Checkbox("Animate View Pos", &animateEyePos))
+
+        DaemonJob job;
+        job.Client = client;
+        job.ReceivedTime = std::chrono::high_resolution_clock::now();
+        try
         {
+            job.Request = JsonValue::Parse(line);
         }
-        ImGui::SameLine();
-        if (ImGui::Checkbox("Normalized Distance", &animatedEyePosNormalize))
+        catch (const std::exception &e)
         {
+            job.Error = e.what();
         }
 
-        ImGui::Spacing();
-        ImGui::Spacing();
-
-        if (ImGui::InputInt3("Dispatch Size", glm::value_ptr(dispatchSize)))
         {
-            recreateParticlesSSBO();
+            std::lock_guard lock{daemonMutex};
+            daemonQueue.push_back(std::move(job));
         }
+        daemonCondition.notify_one();
+    }
+}
 
-        std::stringstream ss;
-        ss.imbue(std::locale(""));
-        ss << getParticleCount();
-        ImGui::Text("Particles: %s", ss.str().c_str());
+static glm::vec4 readAttractorParameters(const JsonValue &value)
+{
+    if (value.Type != JsonType::Array || value.Array.size() != 4)
+    {
+        throw std::runtime_error("Attractors must be arrays of 4 numbers");
+    }
+    return {static_cast<float>(value.Array[0].Number), static_cast<float>(value.Array[1].Number), static_cast<float>(value.Array[2].Number), static_cast<float>(value.Array[3].Number)};
+}
 
-        ImGui::Spacing();
-        ImGui::Spacing();
+// Settings every daemon job starts from, taken once the daemon has initialized, so keys a job leaves out never inherit
+// the previous job's values
+struct DaemonDefaults
+{
+    std::vector<AttractorInstanceSettings> AttractorInstances;
+    glm::vec3 EyePos{0.0f};
+    float EMax = 0.0f;
+    float OutputScalar = 0.0f;
+    glm::ivec2 Resolution{0};
+    glm::ivec3 DispatchSize{0};
+};
 
-        if (ImGui::InputFloat4("Attractors", glm::value_ptr(attractors)))
-        {
-            updateAttractors();
-        }
+static DaemonDefaults daemonDefaults;
 
-        if (ImGui::BeginCombo("##Attractor Presets", "Attractor Presets"))
+// Renders one job with the warm context and writes its image. Buffers are only reallocated when the job changes their size
+static std::string runDaemonJob(const JsonValue &request)
+{
+    const auto outputPath = request.GetString("output", "");
+    if (outputPath.empty())
+    {
+        throw std::runtime_error("Job has no output path");
+    }
+
+    // "attractors" is one parameter set, or an array of them for several instances
+    attractorInstances = daemonDefaults.AttractorInstances;
+    if (const auto attractors = request.Find("attractors"))
+    {
+        std::vector<AttractorInstanceSettings> instances;
+        if (attractors->Type == JsonType::Array && !attractors->Array.empty() && attractors->Array.front().Type == JsonType::Array)
         {
-            for (size_t i = 0; i < attractorPresets.size(); i++)
+            for (const auto &parameters : attractors->Array)
             {
-                std::string label = "Preset " + std::to_string(i + 1);
-                if (ImGui::Selectable(label.c_str(), false))
-                {
-                    attractors = attractorPresets[i];
-                    updateAttractors();
-                }
+                instances.emplace_back().Parameters = readAttractorParameters(parameters);
             }
-
-            ImGui::EndCombo();
-        }
-
-        ImGui::Spacing();
-        ImGui::Spacing();
-
-        if (ImGui::ColorEdit3("Cold Color", glm::value_ptr(coldColor)))
-        {
-            updateColors();
         }
-        if (ImGui::ColorEdit3("Hot Color", glm::value_ptr(hotColor)))
+        else
         {
-            updateColors();
+            instances.emplace_back().Parameters = readAttractorParameters(*attractors);
         }
-
-        ImGui::Spacing();
-        ImGui::Spacing();
-
-        ImGui::Text("FPS: %.1f", 1.0f / deltaTime);
-
-        ImGui::End();
+        attractorInstances = instances;
     }
-}
-
-static void appCleanup()
-{
-    outputProgram.reset();
-    particlesProgram.reset();
-    uintPixels.reset();
-}
 
-static void processInput(GLFWwindow *window);
-static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
-static void APIENTRY debugMessageCallback(GLenum source, GLenum type, unsigned int id, GLenum severity, GLsizei length, const char *message, const void *userParam);
+    eyePos = daemonDefaults.EyePos;
+    request.GetNumbers("eye", glm::value_ptr(eyePos), 3);
 
-static void app()
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#if __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-#ifndef NDEBUG
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
-#endif
+    // SSBO sizes are 32-bit, and the driver may allow less. Checked before converting, as out of range floats do not
+    // convert to integers
+    GLint64 maxBlockSize = 0;
+    glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxBlockSize);
+    const auto maxBufferSize = std::min<uint64_t>(static_cast<uint64_t>(std::max<GLint64>(maxBlockSize, 0)), std::numeric_limits<unsigned int>::max());
 
-    GLFWwindow *window = glfwCreateWindow(INITIAL_WIDTH, INITIAL_HEIGHT, "SomeParticles", nullptr, nullptr);
-    if (window == nullptr)
+    float resolution[2] = {static_cast<float>(daemonDefaults.Resolution.x), static_cast<float>(daemonDefaults.Resolution.y)};
+    request.GetNumbers("resolution", resolution, 2);
+    if (!(resolution[0] >= 1.0f && resolution[1] >= 1.0f && static_cast<double>(resolution[0]) * resolution[1] * sizeof(uint64_t) <= static_cast<double>(maxBufferSize)))
     {
-        glfwTerminate();
-        throw std::runtime_error("Failed to create GLFW window");
+        throw std::runtime_error("Resolution must be positive and fit in a pixel buffer");
+    }
+    const glm::ivec2 newParticleSize{static_cast<int>(resolution[0]), static_cast<int>(resolution[1])};
+    if (GetPixelBufferLength(pixelLayout, newParticleSize.x, newParticleSize.y, GetViewCount(viewMode, orbitViewCount)) * sizeof(uint64_t) > maxBufferSize)
+    {
+        throw std::runtime_error("Resolution does not fit in a pixel buffer");
     }
 
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
-#ifndef VSYNC
-    glfwSwapInterval(0);
-#endif
+    // Particle counts are rounded up to whole work groups of 256
+    auto newDispatchSize = daemonDefaults.DispatchSize;
+    const auto particles = request.GetNumber("particles", 0.0);
+    if (!(particles >= 0.0 && std::ceil(particles / 256.0) * 256.0 * sizeof(glm::vec4) <= static_cast<double>(maxBufferSize)))
+    {
+        throw std::runtime_error("Particles must be a count that fits in a particle buffer");
+    }
+    if (particles > 0.0)
+    {
+        // As few rows of at most 65535 groups as fit the count, then the narrowest row width that covers it, so the
+        // count overshoots by fewer groups than there are rows
+        const auto groups = static_cast<int>(std::ceil(particles / 256.0));
+        const auto rows = (groups + 65534) / 65535;
+        newDispatchSize = glm::ivec3((groups + rows - 1) / rows, rows, 1);
+    }
 
-    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    particleEMax = static_cast<float>(request.GetNumber("eMax", daemonDefaults.EMax));
+    outputScalar = static_cast<float>(request.GetNumber("outputScalar", daemonDefaults.OutputScalar));
+    const auto requestedFrames = request.GetNumber("frames", 1.0);
+    if (!(requestedFrames >= 1.0 && requestedFrames <= std::numeric_limits<int>::max()))
     {
-        throw std::runtime_error("Failed to initialize GLAD");
+        throw std::runtime_error("Frames must be a positive count");
+    }
+    const auto frames = static_cast<int>(requestedFrames);
+    // A splat must still add at least one to the red and blue channels
+    if (particleEMax * static_cast<float>(frames) > static_cast<float>((1 << 21) - 1))
+    {
+        throw std::runtime_error("Too many frames for eMax " + std::to_string(particleEMax));
     }
 
-    // Enable debug
-    int flags;
-    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
-    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+    if (newParticleSize != particleSize)
     {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-        glDebugMessageCallback(&debugMessageCallback, nullptr);
-        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        particleSize = newParticleSize;
+        recreatePixelsSSBO();
+    }
+    bindPixelsSSBO();
+    // Scaled by the frames like posters are, so the accumulated image has the brightness of a single frame and cannot
+    // overflow its packed channels
+    uniforms.Scene.EMax = particleEMax * static_cast<float>(frames);
+    recreateMVP(particleSize.x, particleSize.y);
+    if (newDispatchSize != dispatchSize)
+    {
+        dispatchSize = newDispatchSize;
+        recreateParticlesSSBO();
     }
+    // Restart the particles from scratch too, so the previous job's positions cannot leak into this image
+    updateAttractors();
 
-    // Setup Dear ImGui context
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO &io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad; // Enable Gamepad Controls
-    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; // IF using Docking Branch
+    resetDeterministic();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        appRender();
+    }
 
-    ImGui_ImplGlfw_InitForOpenGL(window, true); // Second param install_callback=true will install GLFW callbacks and chain to existing ones.
-    ImGui_ImplOpenGL3_Init();
+    const auto pixels = readPixels();
+    const auto error = WriteTiff(outputPath, particleSize.x, particleSize.y, ResolvePixels(pixels.data(), particleSize.x, particleSize.y, coldColor, hotColor, outputScalar));
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+    return outputPath;
+}
 
+// Keeps a hidden context, compiled programs and buffers alive, running JSON jobs received on a Unix domain socket
+// back to back. Each request is one line; each reply is one line with the job's timings, or its error
+static void runDaemon(const std::string &socketPath)
+{
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    GLFWwindow *window = createWindow(INITIAL_WIDTH, INITIAL_HEIGHT, false);
     appInit();
+    deterministic = true;
+    accumulatePixels = true;
+    burnInStepsPerFrame = burnInSteps;
+    daemonDefaults = {attractorInstances, eyePos, particleEMax, outputScalar, particleSize, dispatchSize};
 
-    auto lastTime = std::chrono::high_resolution_clock::now();
-    while (!glfwWindowShouldClose(window))
+    auto listener = std::make_shared<Socket>(Socket::ListenLocal(socketPath));
+    std::thread([listener]
     {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(currentTime - lastTime).count();
-        lastTime = currentTime;
+        try
+        {
+            while (true)
+            {
+                auto client = std::make_shared<Socket>(listener->Accept());
+                std::thread(readDaemonClient, client).detach();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << '\n';
+        }
+    }).detach();
 
-        processInput(window);
+    const auto startMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Daemon ready on " << socketPath << " after " << startMilliseconds << " ms\n";
 
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+    bool running = true;
+    while (running)
+    {
+        DaemonJob job;
+        {
+            std::unique_lock lock{daemonMutex};
+            daemonCondition.wait(lock, [] { return !daemonQueue.empty(); });
+            job = std::move(daemonQueue.front());
+            daemonQueue.pop_front();
+        }
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        const auto runTime = std::chrono::high_resolution_clock::now();
+        const auto id = JsonQuote(job.Request.GetString("id", ""));
+        std::string reply;
+        try
+        {
+            if (!job.Error.empty())
+            {
+                throw std::runtime_error(job.Error);
+            }
 
-        appRender();
+            std::string output;
+            if (job.Request.GetString("command", "render") == "shutdown")
+            {
+                running = false;
+            }
+            else
+            {
+                output = runDaemonJob(job.Request);
+            }
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            const auto endTime = std::chrono::high_resolution_clock::now();
+            const auto queueMilliseconds = std::chrono::duration<double, std::milli>(runTime - job.ReceivedTime).count();
+            const auto renderMilliseconds = std::chrono::duration<double, std::milli>(endTime - runTime).count();
+            char timings[128];
+            snprintf(timings, sizeof(timings), "\"queueMs\": %.3f, \"renderMs\": %.3f, \"totalMs\": %.3f", queueMilliseconds, renderMilliseconds, queueMilliseconds + renderMilliseconds);
+            reply = "{\"id\": " + id + ", \"status\": \"ok\", \"output\": " + JsonQuote(output) + ", " + timings + "}";
+        }
+        catch (const std::exception &e)
+        {
+            reply = "{\"id\": " + id + ", \"status\": \"error\", \"error\": " + JsonQuote(e.what()) + "}";
+        }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        std::cout << reply << '\n';
+        try
+        {
+            job.Client->SendAll(reply.data(), reply.size());
+            job.Client->SendAll("\n", 1);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << '\n';
+        }
     }
 
     appCleanup();
-
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+    glfwDestroyWindow(window);
     glfwTerminate();
+    std::filesystem::remove(socketPath);
 }
 
 static void processInput(GLFWwindow *window)
@@ -473,8 +3616,11 @@ static void processInput(GLFWwindow *window)
 
 static void framebufferSizeCallback(GLFWwindow *window, int width, int height)
 {
-    glViewport(0, 0, width, height);
-    appResize(width, height);
+    postRenderCommand([width, height]
+    {
+        glViewport(0, 0, width, height);
+        appResize(width, height);
+    });
 }
 
 // https://learnopengl.com/In-Practice/Debugging
@@ -568,10 +3714,98 @@ void debugMessageCallback(GLenum source, GLenum type, unsigned int id, GLenum se
     std::cout << std::endl;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    std::string goldenDirectory;
+    auto goldenUpdate = GoldenUpdate::None;
+    bool renderPoster = false;
+    std::string workerHost;
+    uint16_t port = 0;
+    uint32_t workerCount = 0;
+    uint32_t frameCount = 0;
+    std::string outputPath;
+    std::string daemonSocketPath;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--deterministic")
+        {
+            deterministic = true;
+        }
+        else if (argument == "--regression" && i + 1 < argc)
+        {
+            goldenDirectory = argv[++i];
+        }
+        else if (argument == "--update-goldens")
+        {
+            goldenUpdate = GoldenUpdate::Gpu;
+        }
+        else if (argument == "--update-goldens-cpu")
+        {
+            goldenUpdate = GoldenUpdate::Cpu;
+        }
+        else if (argument == "--poster" && i + 3 < argc)
+        {
+            posterPath = argv[++i];
+            posterSize.x = std::atoi(argv[++i]);
+            posterSize.y = std::atoi(argv[++i]);
+            renderPoster = true;
+        }
+        else if (argument == "--daemon" && i + 1 < argc)
+        {
+            daemonSocketPath = argv[++i];
+        }
+        else if (argument == "--worker" && i + 2 < argc)
+        {
+            workerHost = argv[++i];
+            port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (argument == "--coordinator" && i + 4 < argc)
+        {
+            port = static_cast<uint16_t>(std::atoi(argv[++i]));
+            workerCount = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+            frameCount = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+            outputPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: SomeParticles [--deterministic] [--regression <golden directory> [--update-goldens | --update-goldens-cpu]] [--poster <path.tif> <width> <height>]\n"
+                         "       [--coordinator <port> <workers> <frames> <path.tif>] [--worker <host> <port>]\n"
+                         "       [--daemon <socket path>]\n";
+            return -1;
+        }
+    }
+
     try
     {
+        if (!goldenDirectory.empty())
+        {
+            if (goldenUpdate == GoldenUpdate::None && !std::filesystem::is_directory(goldenDirectory))
+            {
+                std::cerr << "No goldens in " << goldenDirectory << ", render them on a known good build with --update-goldens\n";
+                return REGRESSION_SKIPPED;
+            }
+            return regression(goldenDirectory, goldenUpdate) == 0 ? 0 : 1;
+        }
+        if (renderPoster)
+        {
+            return posterHeadless(posterPath, posterSize) ? 0 : 1;
+        }
+        if (!daemonSocketPath.empty())
+        {
+            runDaemon(daemonSocketPath);
+            return 0;
+        }
+        if (!workerHost.empty())
+        {
+            worker(workerHost, port);
+            return 0;
+        }
+        if (!outputPath.empty())
+        {
+            coordinator(port, workerCount, frameCount, outputPath);
+            return 0;
+        }
         app();
     }
     catch (const std::exception &e)
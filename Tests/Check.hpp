@@ -0,0 +1,25 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdint>
+
+// Failed checks are printed and counted rather than stopping the test, so one run reports every failure
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+
+void Check(bool passed, const char *condition, const char *file, int line);
+
+// Packs the channels of one R21G22B21 pixel
+inline uint64_t PackTestPixel(const uint32_t r, const uint32_t g, const uint32_t b)
+{
+    return (static_cast<uint64_t>(r) << (21 + 22)) | (static_cast<uint64_t>(g) << 21) | b;
+}
+
+// One function per CTest test, each in the file of the same name
+void TestRandom();
+void TestGolden();
+void TestReducer();
+void TestJson();
+void TestPixelLayout();
+void TestTrig();
+
+#endif //CHECK_HPP
@@ -0,0 +1,57 @@
+// Checks of the CPU side code that needs no GL context. Runs the test named by the only argument, or every test, and
+// returns the number of failed checks
+
+#include <cstdio>
+#include <cstring>
+
+#include "Check.hpp"
+
+static int failures = 0;
+
+void Check(const bool passed, const char *condition, const char *file, const int line)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+        failures++;
+    }
+}
+
+struct NamedTest
+{
+    const char *Name;
+    void (*Run)();
+};
+
+static const NamedTest tests[] = {
+    {"random", TestRandom},
+    {"golden", TestGolden},
+    {"reducer", TestReducer},
+    {"json", TestJson},
+    {"pixel_layout", TestPixelLayout},
+    {"trig", TestTrig},
+};
+
+int main(const int argc, char *argv[])
+{
+    bool found = false;
+    for (const auto &test : tests)
+    {
+        if (argc < 2 || strcmp(argv[1], test.Name) == 0)
+        {
+            test.Run();
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        fprintf(stderr, "Unknown test: %s\n", argv[1]);
+        return 1;
+    }
+
+    if (failures == 0)
+    {
+        printf("All checks passed\n");
+    }
+    return failures;
+}
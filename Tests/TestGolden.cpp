@@ -0,0 +1,67 @@
+// The statistical comparison, the golden files and the CPU render the committed goldens come from
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+#include "Check.hpp"
+#include "Golden.hpp"
+
+void TestGolden()
+{
+    constexpr int width = 32;
+    constexpr int height = 16;
+    std::vector<uint64_t> golden(width * height, 0);
+    for (int y = 4; y < 12; y++)
+    {
+        for (int x = 8; x < 24; x++)
+        {
+            golden[y * width + x] = PackTestPixel(100 + x, 200 + y, 50);
+        }
+    }
+
+    const auto same = CompareGoldenPixels(golden.data(), golden.data(), width, height);
+    CHECK(same.Passed && same.FluxRatio == 1.0 && same.PixelDistance == 0.0 && same.BlockDistance == 0.0);
+
+    std::vector<uint64_t> brighter(golden.size());
+    for (size_t i = 0; i < golden.size(); i++)
+    {
+        brighter[i] = golden[i] * 2;
+    }
+    const auto bright = CompareGoldenPixels(golden.data(), brighter.data(), width, height);
+    CHECK(!bright.Passed && std::abs(bright.FluxRatio - 2.0) < 1e-9 && bright.BlockDistance < 1e-9);
+
+    // Same flux moved a whole block to the right
+    std::vector<uint64_t> shifted(golden.size(), 0);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x + GOLDEN_BLOCK_SIZE < width; x++)
+        {
+            shifted[y * width + x + GOLDEN_BLOCK_SIZE] = golden[y * width + x];
+        }
+    }
+    const auto moved = CompareGoldenPixels(golden.data(), shifted.data(), width, height);
+    CHECK(!moved.Passed && std::abs(moved.FluxRatio - 1.0) < 1e-9);
+
+    // Block sums survive the golden file
+    const auto path = (std::filesystem::temp_directory_path() / "SomeParticlesTests.golden").string();
+    const auto blocks = SumGoldenBlocks(golden.data(), width, height);
+    WriteGoldenBlocks(path, blocks);
+    const auto read = ReadGoldenBlocks(path);
+    std::filesystem::remove(path);
+    CHECK(read.Width == width && read.Height == height && read.Sums == blocks.Sums);
+    CHECK(CompareGoldenBlocks(read, SumGoldenBlocks(brighter.data(), width, height)).FluxRatio == bright.FluxRatio);
+
+    // The CPU render does not depend on how its particles are split between threads
+    GoldenScene scene;
+    scene.Instances.emplace_back().Range = glm::uvec4(0u, 4096u, 0u, 0u);
+    scene.Instances.front().Parameters = glm::vec4(-1.4f, 1.6f, 1.0f, 0.7f);
+    scene.Resolution = glm::ivec2(width, height);
+    scene.EMax = 100.0f;
+    scene.ParticleCount = 4096;
+    scene.BurnInSteps = 8;
+    scene.FrameSeeds = {1u, 2u, 3u, 4u};
+    const auto rendered = RenderGoldenScene(scene, 1);
+    CHECK(rendered == RenderGoldenScene(scene, 3));
+    CHECK(SumGoldenBlocks(rendered.data(), width, height).Sums != std::vector<uint64_t>(blocks.Sums.size(), 0));
+}
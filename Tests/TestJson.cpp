@@ -0,0 +1,60 @@
+// The JSON parser the daemon reads its jobs with
+
+#include <stdexcept>
+#include <string>
+
+#include "Check.hpp"
+#include "Json.hpp"
+
+void TestJson()
+{
+    const auto job = JsonValue::Parse(R"({"id": "a\"b", "eye": [1.5, 5, -5e-1], "frames": 8, "nested": {"list": [true, false, null]}})");
+    CHECK(job.Type == JsonType::Object);
+    CHECK(job.GetString("id", "") == "a\"b");
+    CHECK(job.GetNumber("frames", 0.0) == 8.0);
+    CHECK(job.GetNumber("missing", 3.0) == 3.0);
+    CHECK(job.GetString("frames", "fallback") == "fallback");
+
+    float eye[3] = {};
+    job.GetNumbers("eye", eye, 3);
+    CHECK(eye[0] == 1.5f && eye[1] == 5.0f && eye[2] == -0.5f);
+
+    float unchanged[2] = {7.0f, 8.0f};
+    job.GetNumbers("missing", unchanged, 2);
+    CHECK(unchanged[0] == 7.0f && unchanged[1] == 8.0f);
+
+    const auto nested = job.Find("nested");
+    CHECK(nested != nullptr && nested->Find("list") != nullptr && nested->Find("list")->Array.size() == 3);
+
+    const auto throws = [](const std::string &text)
+    {
+        try
+        {
+            JsonValue::Parse(text);
+        }
+        catch (const std::runtime_error &)
+        {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws("{\"a\": 1} trailing"));
+    CHECK(throws("{\"a\": "));
+    CHECK(throws("[1, 2"));
+    CHECK(throws("\"unterminated"));
+    CHECK(throws("{\"eye\": [1, 2]}") == false);
+
+    bool wrongCount = false;
+    try
+    {
+        JsonValue::Parse("{\"eye\": [1, 2]}").GetNumbers("eye", eye, 3);
+    }
+    catch (const std::runtime_error &)
+    {
+        wrongCount = true;
+    }
+    CHECK(wrongCount);
+
+    const std::string text = "path\\with \"quotes\"\nand\ttabs";
+    CHECK(JsonValue::Parse(JsonQuote(text)).String == text);
+}
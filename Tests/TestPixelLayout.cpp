@@ -0,0 +1,47 @@
+// The pixel buffer layouts, every pixel of which must map to its own index
+
+#include <set>
+#include <vector>
+
+#include "Check.hpp"
+#include "PixelLayout.hpp"
+
+void TestPixelLayout()
+{
+    // Not a multiple of the block size, so the Morton layout is padded
+    constexpr int width = 37;
+    constexpr int height = 21;
+    constexpr int layers = 2;
+
+    for (const auto layout : {PixelLayout::RowMajor, PixelLayout::Morton})
+    {
+        const auto length = GetPixelBufferLength(layout, width, height, layers);
+        CHECK(length >= static_cast<size_t>(width) * height * layers);
+
+        std::set<size_t> indices;
+        std::vector<uint64_t> pixels(length, 0);
+        for (int layer = 0; layer < layers; layer++)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const auto index = GetPixelIndex(layout, x, y, layer, width, height);
+                    CHECK(index < length);
+                    indices.insert(index);
+                    pixels[index] = (static_cast<uint64_t>(layer) * height + y) * width + x;
+                }
+            }
+        }
+        CHECK(indices.size() == static_cast<size_t>(width) * height * layers);
+
+        const auto rowMajor = ToRowMajor(layout, pixels, width, height, layers);
+        CHECK(rowMajor.size() == static_cast<size_t>(width) * height * layers);
+        for (size_t i = 0; i < rowMajor.size(); i++)
+        {
+            CHECK(rowMajor[i] == i);
+        }
+    }
+
+    CHECK(GetPixelBufferLength(PixelLayout::Morton, 37, 21, 2) == 3 * 2 * PIXEL_BLOCK_SIZE * PIXEL_BLOCK_SIZE * 2);
+}
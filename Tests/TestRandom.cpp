@@ -0,0 +1,36 @@
+// Pins the CPU mirrors of the random generators, so they cannot change without random.glsl changing with them
+
+#include <cmath>
+
+#include "Check.hpp"
+#include "Random.hpp"
+
+void TestRandom()
+{
+    // Published Philox4x32-10 answers from Random123
+    CHECK(RandomPhilox4x32(glm::uvec4(0u), glm::uvec2(0u)) == glm::uvec4(0x6627E8D5u, 0xE169C58Du, 0xBC57AC4Cu, 0x9B00DBD8u));
+    CHECK(RandomPhilox4x32(glm::uvec4(0x243F6A88u, 0x85A308D3u, 0x13198A2Eu, 0x03707344u), glm::uvec2(0xA4093822u, 0x299F31D0u)) == glm::uvec4(0xD16CFE09u, 0x94FDCCEBu, 0x5001E420u, 0x24126EA1u));
+
+    CHECK(RandomPCG4D(glm::uvec4(0u)) == glm::uvec4(0x0F02F829u, 0x2D568769u, 0x32B0C43Bu, 0xD32548EAu));
+    CHECK(RandomPCG4D(glm::uvec4(1u, 2u, 3u, 4u)) == glm::uvec4(0x3622CD16u, 0xF11471D8u, 0xE1109B3Fu, 0x02B94C2Fu));
+    CHECK(RandomWords(RandomGenerator::PCG, 0, 7u, 42u, 0u) == glm::uvec4(0xC2D8C06Bu, 0xFDEB20E2u, 0x42904C77u, 0x86AF9BE5u));
+
+    // R3 steps every particle by the same fixed-point offset
+    const auto first = RandomWords(RandomGenerator::R3, 0, 1000u, 42u, 3u);
+    const auto next = RandomWords(RandomGenerator::R3, 0, 1001u, 42u, 3u);
+    CHECK(next.x - first.x == 0xD1B54A33u && next.y - first.y == 0xABC98389u && next.z - first.z == 0x8CB92BA7u);
+    CHECK(RandomWords(RandomGenerator::R3, 0, 1000u, 42u, 4u) != first);
+
+    for (const auto generator : {RandomGenerator::TEA, RandomGenerator::PCG, RandomGenerator::Philox, RandomGenerator::R3})
+    {
+        const auto position = RandomUnitVec3(RandomWords(generator, 4, 12345u, 678u, 0u));
+        CHECK(position.x >= 0.0f && position.x < 1.0f && position.y >= 0.0f && position.y < 1.0f && position.z >= 0.0f && position.z < 1.0f);
+    }
+
+    // Loose bounds, far outside the spread of a sound generator
+    const auto report = EvaluateRandomQuality(RandomGenerator::PCG, 4, 1u, 1u << 16);
+    CHECK(report.ChiSquare < 400.0);
+    CHECK(std::abs(report.Mean - 0.5) < 0.01);
+    CHECK(std::abs(report.SerialCorrelation) < 0.02);
+    CHECK(report.MaxBitBias < 0.02);
+}
@@ -0,0 +1,46 @@
+// The coordinator's reduction of the workers' pixel buffers
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Check.hpp"
+#include "Distributed.hpp"
+
+void TestReducer()
+{
+    // Odd length, so the scalar tail after the paired adds is covered too
+    constexpr size_t count = 1001;
+    std::vector<std::vector<uint64_t>> buffers(3, std::vector<uint64_t>(count));
+    for (size_t i = 0; i < count; i++)
+    {
+        // Full blue channels, which must saturate rather than carry into green
+        buffers[0][i] = PackTestPixel(static_cast<uint32_t>(i), 1, 0x1FFFFF);
+        buffers[1][i] = PackTestPixel(2, static_cast<uint32_t>(i * 3), 1);
+        buffers[2][i] = PackTestPixel(static_cast<uint32_t>(i * 2000), 0x3FFFFF, static_cast<uint32_t>(i));
+    }
+    const std::vector<const uint64_t *> sources{buffers[0].data(), buffers[1].data(), buffers[2].data()};
+
+    for (const auto scale : {1.0, 0.25})
+    {
+        std::vector<uint64_t> expected(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto channel = [scale](const uint64_t sum, const uint64_t max)
+            {
+                return std::min(static_cast<uint64_t>(std::floor(static_cast<double>(sum) * scale + 0.5)), max);
+            };
+            const auto red = i + 2 + i * 2000;
+            const auto green = 1 + i * 3 + 0x3FFFFF;
+            const auto blue = 0x1FFFFF + 1 + i;
+            expected[i] = PackTestPixel(static_cast<uint32_t>(channel(red, 0x1FFFFF)), static_cast<uint32_t>(channel(green, 0x3FFFFF)), static_cast<uint32_t>(channel(blue, 0x1FFFFF)));
+        }
+
+        for (const auto threads : {1u, 3u, 8u})
+        {
+            std::vector<uint64_t> destination(count, ~0ull);
+            ReducePixelBuffers(destination.data(), sources, count, scale, threads);
+            CHECK(destination == expected);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// The polynomial and shared trig variants against the native functions
+
+#include <algorithm>
+#include <cmath>
+
+#include "Check.hpp"
+#include "Trig.hpp"
+
+void TestTrig()
+{
+    double maxError = 0.0;
+    for (float x = -100.0f; x <= 100.0f; x += 0.01f)
+    {
+        maxError = std::max<double>(maxError, std::abs(TrigSin(TrigMode::Polynomial, x) - std::sin(x)));
+        maxError = std::max<double>(maxError, std::abs(TrigCos(TrigMode::Polynomial, x) - std::cos(x)));
+    }
+    CHECK(maxError < 2e-5);
+
+    const glm::vec4 attractors{-1.4f, 1.6f, 1.0f, 0.7f};
+    const glm::vec3 position{0.3f, -0.2f, 0.5f};
+    const auto native = AttractorStep(TrigMode::Native, position, attractors);
+    CHECK(AttractorStep(TrigMode::Shared, position, attractors) == native);
+    CHECK(glm::length(AttractorStep(TrigMode::Polynomial, position, attractors) - native) < 1e-4f);
+
+    CHECK(GetTrigShaderDefines(TrigMode::Native).empty());
+    CHECK(GetTrigShaderDefines(TrigMode::Polynomial).size() == 2);
+}